@@ -26,5 +26,8 @@ SET RELSL=ON
 REM Разрешить инвазивный доступ к буферу std::string (ересь)
 SET SBIAC=OFF
 
-SET RELEASE_OPTS=-D BUILD_SEPARATED=%SEPARATED% -D BUILD_STATIC=%STATIC% -D WITH_RELSL=%RELSL% -D WITH_SBIAC=%SBIAC%
+REM Поддержка HTTP/2 (nghttp2)
+SET HTTP2=OFF
+
+SET RELEASE_OPTS=-D BUILD_SEPARATED=%SEPARATED% -D BUILD_STATIC=%STATIC% -D WITH_RELSL=%RELSL% -D WITH_SBIAC=%SBIAC% -D WITH_HTTP2=%HTTP2%
 SET DEBUG_OPTS=%RELEASE_OPTS% -D WITH_ASAN=%ASAN% -D WITH_UBSAN=%UBSAN% -D WITH_CRTDBG=%CRTDBG% -D WITH_LEAKS=%LEAKS%
@@ -0,0 +1,53 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#pragma once
+
+#include "http_types.h"
+#include "http_strings.h"
+#include "http_wire.h"
+#include "http_serialized_response.h"
+#include <lib/datetime.h>
+#include <cassert>
+#include <utility>
+#include <memory>
+#include <string>
+
+namespace Http {
+    // Ранее полученный ответ, отдаваемый с заголовком 'Age': сколько секунд назад получены данные.
+    // Сериализованные байты общие для всех запросов, отдельно формируется только начало заголовка.
+    struct AgedResponse final : ProtoResponse {
+        const std::shared_ptr<SerializedResponse> m_origin;
+        std::string m_ageHeader {};
+
+        AgedResponse() = delete;
+
+        AgedResponse(std::shared_ptr<SerializedResponse> origin, const DateTime::Offset age)
+        : ProtoResponse(), m_origin { std::move(origin) } {
+            assert(m_origin);
+            m_ageHeader.append(Mbs::c_agePrefix);
+            appendNumber(m_ageHeader, static_cast<size_t>(age.count() < 0 ? 0 : age.count()));
+            m_ageHeader.append(Mbs::c_crlf);
+        }
+
+        AgedResponse(const AgedResponse &) = delete;
+        AgedResponse(AgedResponse &&) = delete;
+        ~AgedResponse() override = default;
+
+        AgedResponse & operator=(const AgedResponse &) = delete;
+        AgedResponse & operator=(AgedResponse &&) = delete;
+
+        explicit operator bool() override {
+            return static_cast<bool>(*m_origin);
+        }
+
+        [[nodiscard]]
+        bool keepAliveReady() const noexcept override {
+            return m_origin->keepAliveReady();
+        }
+
+        void render(Wire & wire, Status, const bool keepAlive) override {
+            m_origin->render(wire, keepAlive, m_ageHeader);
+        }
+    };
+}
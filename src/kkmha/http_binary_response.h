@@ -4,14 +4,10 @@
 #pragma once
 
 #include "http_types.h"
-#include "http_strings.h"
 #include "http_proto_response.h"
-#include <lib/meta.h>
 #include <type_traits>
-#include <cassert>
 #include <memory>
-#include <ostream>
-#include <format>
+#include <string_view>
 
 namespace Http {
     using Unique = std::unique_ptr<char[]>;
@@ -35,6 +31,8 @@ namespace Http {
     template<CustomPointer T>
     struct BinaryResponse final : ProtoResponse {
         std::string m_mimeType {};
+        std::string m_headers {}; // Дополнительные строки заголовка, каждая с CRLF
+        std::string m_tag {}; // Строгий валидатор несжатого варианта, у сжатого он свой (см. codedTag())
         T m_data { nullptr };
         size_t m_size { 0 };
 
@@ -54,32 +52,17 @@ namespace Http {
             return m_data && m_size;
         }
 
-        void render(Asio::StreamBuffer & buffer, const Status status) override {
-            assert(Mbs::c_statusStrings.contains(status));
-            std::ostream output { &buffer };
-            if (m_data && m_size) {
-                output
-                    << std::format(
-                        Mbs::c_staticResponseHeaderTemplate,
-                        Meta::toUnderlying(status),
-                        Mbs::c_statusStrings.at(status),
-                        m_mimeType,
-                        m_size
-                    );
-                if constexpr (isSmart<T>) {
-                    output.write(m_data.get(), static_cast<std::streamsize>(m_size));
-                } else {
-                    output.write(m_data, static_cast<std::streamsize>(m_size));
-                }
+        void render(Wire & wire, const Status status, const bool keepAlive) override {
+            const size_t size { m_data ? m_size : 0 };
+            if constexpr (isSmart<T>) {
+                renderBody(
+                    wire, status, keepAlive, false, m_mimeType, std::string_view { m_data.get(), size }, m_headers,
+                    m_tag
+                );
             } else {
-                output
-                    << std::format(
-                        Mbs::c_staticResponseHeaderTemplate,
-                        Meta::toUnderlying(status),
-                        Mbs::c_statusStrings.at(status),
-                        m_mimeType,
-                        0
-                    );
+                renderBody(
+                    wire, status, keepAlive, false, m_mimeType, std::string_view { m_data, size }, m_headers, m_tag
+                );
             }
         }
     };
@@ -4,18 +4,17 @@
 #pragma once
 
 #include "http_types.h"
+#include "http_strings.h"
 #include "http_proto_response.h"
 #include <memory>
 #include <string_view>
-#include <ostream>
 
 namespace Http {
     using namespace std::string_view_literals;
 
     struct ConstantResponse final : ProtoResponse {
         static inline const auto s_okResponse = std::make_shared<ConstantResponse>(
-            "HTTP/1.1 200 OK\r\n"
-            "Connection: close\r\n"
+            "HTTP/1.1 200 OK\r\n"sv,
             "Pragma: no-cache\r\n"
             "Cache-Control: no-cache, private\r\n"
             "Content-Type: application/json\r\n"
@@ -23,13 +22,24 @@ namespace Http {
             "{\"!message\":\"OK\",\"!success\":true}"sv
         );
 
+        static inline const auto s_serviceUnavailableResponse = std::make_shared<ConstantResponse>(
+            "HTTP/1.1 503 Service Unavailable\r\n"sv,
+            "Retry-After: 2\r\n"
+            "Pragma: no-cache\r\n"
+            "Cache-Control: no-cache, private\r\n"
+            "Content-Type: application/json\r\n"
+            "Content-Length: 51\r\n\r\n"
+            "{\"!message\":\"Service Unavailable\",\"!success\":false}"sv
+        );
+
+        const std::string_view m_statusLine;
         const std::string_view m_data;
 
         ConstantResponse() = delete;
 
         [[maybe_unused]]
-        explicit constexpr ConstantResponse(const std::string_view data)
-        : ProtoResponse(), m_data { data } {}
+        constexpr ConstantResponse(const std::string_view statusLine, const std::string_view data)
+        : ProtoResponse(), m_statusLine { statusLine }, m_data { data } {}
 
         ConstantResponse(const ConstantResponse &) = delete;
         ConstantResponse(ConstantResponse &&) = delete;
@@ -42,9 +52,9 @@ namespace Http {
             return !m_data.empty();
         }
 
-        void render(Asio::StreamBuffer & buffer, Status) override {
-            std::ostream output { &buffer };
-            output << m_data;
+        void render(Wire & wire, Status, const bool keepAlive) override {
+            wire.head().append(m_statusLine).append(Mbs::connection(keepAlive));
+            wire.body(m_data);
         }
     };
 }
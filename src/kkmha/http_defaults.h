@@ -4,6 +4,5 @@
 #pragma once
 
 namespace Http {
-    constexpr size_t c_parserBufferSize { 2'048 };
     constexpr size_t c_requestBodySizeLimit { 131'072 };
 }
@@ -0,0 +1,116 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#pragma once
+
+#include "http_types.h"
+#include <lib/hash.h>
+#include <zlib.h>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace Http::Gzip {
+    constexpr std::string_view c_coding { "gzip" };
+    constexpr int c_windowBits { 15 + 16 }; // +16 - формат gzip вместо zlib
+    constexpr int c_memoryLevel { 8 };
+
+    [[nodiscard]]
+    constexpr std::string_view trimmed(std::string_view text) noexcept {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+
+    // Нулевой вес (q=0, q=0.0, ...) означает отказ от кодирования (RFC 9110, п. 12.4.2).
+    [[nodiscard]]
+    constexpr bool rejected(std::string_view parameters) noexcept {
+        while (!parameters.empty()) {
+            const auto end = parameters.find(';');
+            const auto parameter = trimmed(parameters.substr(0, end));
+            parameters = end == std::string_view::npos ? std::string_view {} : parameters.substr(end + 1);
+            if (parameter.size() < 2 || Hash::lowered(parameter[0]) != 'q' || parameter[1] != '=') {
+                continue;
+            }
+            for (const auto ch : trimmed(parameter.substr(2))) {
+                if (ch != '0' && ch != '.') {
+                    return false;
+                }
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // Принимает ли клиент gzip по значению поля Accept-Encoding. Явно указанный gzip важнее '*'.
+    [[nodiscard]]
+    constexpr bool accepted(std::string_view acceptEncoding) noexcept {
+        bool any { false };
+        while (!acceptEncoding.empty()) {
+            const auto end = acceptEncoding.find(',');
+            const auto item = acceptEncoding.substr(0, end);
+            acceptEncoding = end == std::string_view::npos ? std::string_view {} : acceptEncoding.substr(end + 1);
+            const auto separator = item.find(';');
+            const auto coding = trimmed(item.substr(0, separator));
+            const auto parameters
+                = separator == std::string_view::npos ? std::string_view {} : item.substr(separator + 1);
+            if (equalsIgnoreCase(coding, c_coding) || equalsIgnoreCase(coding, "x-gzip")) {
+                return !rejected(parameters);
+            }
+            if (coding == "*") {
+                any = !rejected(parameters);
+            }
+        }
+        return any;
+    }
+
+    // Сжатие имеет смысл только для текстовых форматов; изображения и архивы уже сжаты.
+    [[nodiscard]]
+    constexpr bool compressible(const std::string_view mimeType) noexcept {
+        const auto type = trimmed(mimeType.substr(0, mimeType.find(';')));
+        if (type.size() > 5 && equalsIgnoreCase(type.substr(0, 5), "text/")) {
+            return true;
+        }
+        for (const auto suffix : { "json", "javascript", "xml", "wasm" }) {
+            const std::string_view tail { suffix };
+            if (type.size() > tail.size() && equalsIgnoreCase(type.substr(type.size() - tail.size()), tail)) {
+                const auto before = type[type.size() - tail.size() - 1];
+                return before == '/' || before == '+';
+            }
+        }
+        return false;
+    }
+
+    // Возвращает пустую строку, если сжать не удалось или сжатие не уменьшило размер.
+    [[nodiscard]]
+    inline std::string compress(const std::string_view data, const int level = Z_DEFAULT_COMPRESSION) {
+        if (data.empty() || data.size() > std::numeric_limits<uInt>::max()) {
+            return {};
+        }
+
+        z_stream stream {};
+        if (deflateInit2(&stream, level, Z_DEFLATED, c_windowBits, c_memoryLevel, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return {};
+        }
+
+        std::string output(deflateBound(&stream, static_cast<uLong>(data.size())), '\0');
+        stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data())); // NOLINT(*-const-cast)
+        stream.avail_in = static_cast<uInt>(data.size());
+        stream.next_out = reinterpret_cast<Bytef *>(output.data());
+        stream.avail_out = static_cast<uInt>(output.size());
+        const auto result = deflate(&stream, Z_FINISH);
+        const auto size = static_cast<size_t>(stream.total_out);
+        deflateEnd(&stream);
+
+        if (result != Z_STREAM_END || size >= data.size()) {
+            return {};
+        }
+        output.resize(size);
+        return output;
+    }
+}
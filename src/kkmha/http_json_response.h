@@ -6,12 +6,9 @@
 #include "http_types.h"
 #include "http_strings.h"
 #include "http_proto_response.h"
-#include <lib/meta.h>
 #include <lib/json.h>
 #include <cassert>
 #include <utility>
-#include <ostream>
-#include <format>
 
 namespace Http {
     struct JsonResponse final : ProtoResponse {
@@ -59,7 +56,7 @@ namespace Http {
             return !m_data.empty();
         }
 
-        void render(Asio::StreamBuffer & buffer, const Status status) override {
+        void render(Wire & wire, const Status status, const bool keepAlive) override {
             assert(Mbs::c_statusStrings.contains(status));
             assert(m_data.is_object());
             if (!m_data.contains(Json::Mbs::c_successKey) || !m_data[Json::Mbs::c_successKey].is_boolean()) {
@@ -68,17 +65,7 @@ namespace Http {
             if (!m_data.contains(Json::Mbs::c_messageKey) || !m_data[Json::Mbs::c_messageKey].is_string()) {
                 m_data[Json::Mbs::c_messageKey] = Mbs::c_statusStrings.at(status);
             }
-            const std::string text { m_data.dump() };
-            std::ostream output { &buffer };
-            output
-                << std::format(
-                    Mbs::c_responseHeaderTemplate,
-                    Meta::toUnderlying(status),
-                    Mbs::c_statusStrings.at(status),
-                    Mbs::c_jsonMimeType,
-                    text.size()
-                )
-                << text;
+            renderBody(wire, status, keepAlive, true, Mbs::c_jsonMimeType, m_data.dump());
         }
     };
 }
@@ -0,0 +1,58 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#pragma once
+
+#include "http_types.h"
+#include "http_strings.h"
+#include "http_wire.h"
+#include "http_proto_response.h"
+#include <lib/meta.h>
+#include <cassert>
+#include <string>
+#include <string_view>
+
+namespace Http {
+    // Ответ 304 на условный запрос (If-None-Match): статусная строка и валидатор, без тела. Если полный
+    // ответ выбирался по Accept-Encoding, 304 повторяет его 'Vary' (RFC 9110, п. 15.4.5).
+    struct NotModifiedResponse final : ProtoResponse {
+        std::string m_tag;
+        bool m_varied;
+
+        NotModifiedResponse() = delete;
+
+        NotModifiedResponse(const std::string_view tag, const bool varied)
+        : ProtoResponse(), m_tag { tag }, m_varied { varied } {}
+
+        NotModifiedResponse(const NotModifiedResponse &) = delete;
+        NotModifiedResponse(NotModifiedResponse &&) = delete;
+        ~NotModifiedResponse() override = default;
+
+        NotModifiedResponse & operator=(const NotModifiedResponse &) = delete;
+        NotModifiedResponse & operator=(NotModifiedResponse &&) = delete;
+
+        explicit operator bool() override {
+            return true;
+        }
+
+        void render(Wire & wire, const Status status, const bool keepAlive) override {
+            assert(status == Status::NotModified);
+            const auto & reason = Mbs::c_statusStrings.at(status);
+            auto & head = wire.head();
+            head.reserve(64 + reason.size() + m_tag.size());
+            head.append(Mbs::c_statusLinePrefix);
+            appendNumber(head, static_cast<size_t>(Meta::toUnderlying(status)));
+            head.push_back(' ');
+            head.append(reason);
+            head.append(Mbs::c_crlf);
+            head.append(Mbs::connection(keepAlive));
+            head.append(Mbs::c_etagPrefix);
+            head.append(m_tag);
+            head.append(Mbs::c_crlf);
+            if (m_varied) {
+                head.append(Mbs::c_varyHeader);
+            }
+            head.append(Mbs::c_crlf);
+        }
+    };
+}
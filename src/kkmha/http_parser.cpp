@@ -2,117 +2,71 @@
 // Distributed under the MIT License, see accompanying file LICENSE.txt
 
 #include "http_parser.h"
-#include "http_defaults.h"
+#include "http_strings.h"
 #include <lib/text.h>
 #include <log/write.h>
+#include <cassert>
 
 namespace Http {
-    using Basic::Failure;
+    void Parser::operator()(const Asio::StreamBuffer & buffer) {
+        const auto data = buffer.data();
+        m_data = { static_cast<const char *>(data.data()), data.size() };
 
-    void Parser::parseMethod(std::istream & stream) {
-        std::string line;
-        std::getline(stream, line);
-
-        auto pos1 = line.find_first_of(' ');
-        if (pos1 == std::string::npos) {
-            m_request.m_response.m_status = Status::BadRequest;
-            m_reader = &Parser::dummyReader;
+        if (m_request.m_response.m_status != Status::Ok) {
             return;
         }
-        m_request.m_verb.assign(line.data(), line.data() + pos1);
 
-        ++pos1;
-        auto pos2 = line.find_first_of(" ?#\r\n", pos1);
-        if (pos2 == std::string::npos || pos1 == pos2) {
-            m_request.m_response.m_status = Status::BadRequest;
-            m_reader = &Parser::dummyReader;
-            return;
+        switch (m_scanner.feed(m_data)) {
+            case Scanner::Result::BadRequest:
+                m_request.m_response.m_status = Status::BadRequest;
+                break;
+            case Scanner::Result::NotImplemented:
+                m_request.m_response.m_status = Status::NotImplemented;
+                break;
+            case Scanner::Result::BodyTooLarge:
+                LOG_ERROR_TS(Wcs::c_bodySizeLimitExceeded, m_request.m_id);
+                m_request.m_response.m_status = Status::BadRequest;
+                m_request.m_response.m_data.emplace<1>(Mbs::c_bodySizeLimitExceeded);
+                break;
+            default:
+                m_request.m_method = m_scanner.method();
         }
-        m_request.m_path.assign(line.data() + pos1, line.data() + pos2);
+    }
 
-        Text::splitTo(m_request.m_hint, Text::lowered<std::string>({ line.c_str(), pos2 }), " /\\");
-        if (m_request.m_hint.empty()) {
+    void Parser::complete() {
+        if (m_request.m_response.m_status == Status::Ok && m_scanner.result() != Scanner::Result::Complete) {
             m_request.m_response.m_status = Status::BadRequest;
-            m_reader = &Parser::dummyReader;
-            return;
         }
 
-        if (m_request.m_hint[0] == "post") {
-            m_request.m_method = Method::Post;
-        } else if (m_request.m_hint[0] == "get") {
-            m_request.m_method = Method::Get;
-        } else {
-            m_request.m_response.m_status = Status::NotImplemented;
-            m_reader = &Parser::dummyReader;
-            return;
-        }
-
-        m_reader = &Parser::parseHeader;
-        ++m_step;
-    }
+        // Строка запроса нужна и для ответа об ошибке: по подсказкам определяется маршрут в метриках.
+        m_request.m_verb = m_scanner.verb().view(m_data);
+        m_request.m_path = m_scanner.target().view(m_data);
+        m_request.m_query = m_scanner.query().view(m_data);
+        m_request.route();
 
-    void Parser::parseHeader(std::istream & stream) {
-        std::string line;
-        std::getline(stream, line);
-        Text::trim(line);
-
-        if (line.empty()) {
-            if (m_request.m_method == Method::Post && m_expectedBodySize) {
-                ++m_step;
-                m_reader = &Parser::parseBody;
-            } else {
-                m_reader = &Parser::dummyReader;
+        if (m_request.m_response.m_status != Status::Ok) {
+            assert(Mbs::c_statusStrings.contains(m_request.m_response.m_status));
+            if (m_request.emptyResponse()) {
+                m_request.m_response.m_data = Mbs::c_statusStrings.at(m_request.m_response.m_status);
             }
             return;
         }
 
-        std::string field, value;
-        Text::splitVariable(line, field, value);
-        m_request.m_header[field] = value;
-        if (field == "content-length") {
-            m_expectedBodySize = Text::cast<size_t>(value);
-            if (m_expectedBodySize > c_requestBodySizeLimit) {
-                LOG_ERROR_TS(Wcs::c_bodySizeLimitExceeded, m_request.m_id);
-                m_expectedBodySize = 0;
-                m_request.m_response.m_status = Status::BadRequest;
-                m_request.m_response.m_data.emplace<1>(Mbs::c_bodySizeLimitExceeded);
-                m_reader = &Parser::dummyReader;
-            } else {
-                m_request.m_body.reserve(m_expectedBodySize + 1);
-            }
+        m_request.m_body = m_scanner.body().view(m_data);
+        m_request.m_header.reserve(m_scanner.fieldCount());
+        for (size_t i = 0; i < m_scanner.fieldCount(); ++i) {
+            const auto & field = m_scanner.field(i);
+            m_request.m_header.emplace(field.m_field, field.m_name.view(m_data), field.m_value.view(m_data));
         }
-    }
 
-    void Parser::parseBody(std::istream & stream) {
-        char buffer[c_parserBufferSize];
-        while (stream.read(buffer, sizeof(buffer))) {
-            m_request.m_body.append(buffer, sizeof(buffer));
-        }
-        m_request.m_body.append(buffer, stream.gcount());
-    }
-
-    void Parser::dummyReader(std::istream & stream) { // NOLINT(*-convert-member-functions-to-static)
-        stream.ignore(std::numeric_limits<std::streamsize>::max());
-    }
-
-    void Parser::operator()(Asio::StreamBuffer & buffer) {
-        try {
-            std::istream input(&buffer);
-            std::noskipws(input);
-            while (input.good()) {
-                (this->*m_reader)(input);
+        m_request.m_keepAlive = m_scanner.version().view(m_data) == "HTTP/1.1";
+        if (m_request.m_header.has(Field::Connection)) {
+            const auto value = Text::lowered(m_request.m_header[Field::Connection]);
+            if (value.find("close") != std::string::npos) {
+                m_request.m_keepAlive = false;
+            } else if (value.find("keep-alive") != std::string::npos) {
+                m_request.m_keepAlive = true;
             }
-            return; /** Не удаляй, смотри дальше. **/
-        } catch (const Failure & e) {
-            LOG_ERROR_TS(e);
-        } catch (const std::exception & e) {
-            LOG_ERROR_TS(e);
-        } catch (...) {
-            LOG_ERROR_TS(Basic::Wcs::c_somethingWrong);
-        }
-        if (m_request.m_response.m_status == Status::Ok) {
-            m_request.m_response.m_status = Status::BadRequest;
         }
-        m_reader = &Parser::dummyReader;
     }
 }
@@ -4,25 +4,17 @@
 #pragma once
 
 #include "http_types.h"
-#include "http_strings.h"
+#include "http_defaults.h"
 #include "http_request.h"
-#include <cassert>
-#include <istream>
-#include <string>
+#include "http_scanner.h"
+#include "asio.h"
+#include <string_view>
 
 namespace Http {
     class Parser {
-        using Reader = void (Parser::*)(std::istream &);
-
-        void parseMethod(std::istream &);
-        void parseHeader(std::istream &);
-        void parseBody(std::istream &);
-        void dummyReader(std::istream &);
-
         Request & m_request;
-        Reader m_reader { &Parser::parseMethod };
-        size_t m_expectedBodySize { 0 };
-        int m_step { 0 };
+        Scanner m_scanner { c_requestBodySizeLimit };
+        std::string_view m_data {};
 
     public:
         Parser() = delete;
@@ -34,25 +26,21 @@ namespace Http {
         Parser & operator=(const Parser &) = delete;
         Parser & operator=(Parser &&) = delete;
 
-        void operator()(Asio::StreamBuffer &);
+        void operator()(const Asio::StreamBuffer &);
 
         [[nodiscard]]
-        size_t expecting() const {
-            if (
-                m_request.m_response.m_status == Status::Ok
-                && m_step >= 2
-                && m_request.m_body.size() < m_expectedBodySize
-            ) {
-                return m_expectedBodySize - m_request.m_body.size();
+        size_t expecting() const noexcept {
+            if (m_request.m_response.m_status == Status::Ok) {
+                return m_scanner.expecting(m_data.size());
             }
             return 0;
         }
 
-        void complete() const {
-            assert(Mbs::c_statusStrings.contains(m_request.m_response.m_status));
-            if (m_request.m_response.m_status != Status::Ok && m_request.emptyResponse()) {
-                m_request.m_response.m_data = Mbs::c_statusStrings.at(m_request.m_response.m_status);
-            }
+        void complete();
+
+        [[nodiscard]]
+        size_t consumed() const noexcept {
+            return m_scanner.result() == Scanner::Result::Complete ? m_scanner.consumed() : m_data.size();
         }
     };
 }
@@ -4,7 +4,7 @@
 #pragma once
 
 #include "http_types.h"
-#include "asio.h"
+#include "http_wire.h"
 
 namespace Http {
     struct ProtoResponse {
@@ -18,6 +18,11 @@ namespace Http {
 
         virtual explicit operator bool() = 0;
 
-        virtual void render(Asio::StreamBuffer &, Status) = 0;
+        [[nodiscard]]
+        virtual bool keepAliveReady() const noexcept {
+            return true;
+        }
+
+        virtual void render(Wire &, Status, bool keepAlive) = 0;
     };
 }
@@ -8,34 +8,49 @@
 #include "asio.h"
 #include <lib/datetime.h>
 #include <utility>
+#include <string>
+#include <string_view>
 #include <atomic>
 #include <vector>
+#include <memory_resource>
 
 namespace Http {
     class Request {
         using SequenceType = int64_t;
 
         static constexpr SequenceType c_idMask { 0xfff };
+        static constexpr std::string_view c_hintDelimiters { " /\\" };
+        static constexpr size_t c_hintsReserve { 8 };
         static inline std::atomic<SequenceType> s_sequence { 1 + (DateTime::windows() & c_idMask) };
 
     public:
         using IdType = uint16_t;
 
-        Header m_header {};
+        // Метод, путь, тело и поля заголовка ссылаются на буфер приёма, который должен жить дольше запроса.
+        Header m_header;
         Response m_response {};
-        std::string m_verb {};
-        std::string m_path {};
-        std::string m_body {};
+        std::string_view m_verb {};
+        std::string_view m_path {};
+        std::string_view m_query {}; // Строка параметров без '?', не декодируется
+        std::string_view m_body {};
         Asio::IpAddress m_remote;
-        std::vector<std::string> m_hint {};
+        std::pmr::string m_route; // Метод и путь в нижнем регистре, на эту строку ссылаются подсказки
+        std::pmr::vector<std::string_view> m_hint;
 
         Method m_method { Method::NotImplemented };
+        bool m_keepAlive { false };
         const IdType m_id;
 
         Request() = delete;
 
-        explicit Request(Asio::IpAddress && remote)
-        : m_remote { std::forward<Asio::IpAddress>(remote) },
+        // Контейнеры запроса размещаются в resource - как правило, в арене соединения.
+        explicit Request(
+            Asio::IpAddress && remote,
+            std::pmr::memory_resource * resource = std::pmr::get_default_resource()
+        ) : m_header { resource },
+          m_remote { std::forward<Asio::IpAddress>(remote) },
+          m_route { resource },
+          m_hint { resource },
           m_id { static_cast<IdType>(s_sequence.fetch_add(1 + (DateTime::windows() & c_idMask))) } {}
 
         Request(const Request &) = delete;
@@ -45,6 +60,40 @@ namespace Http {
         Request & operator=(const Request &) = delete;
         Request & operator=(Request &&) = delete;
 
+        // Строит маршрут и подсказки по уже заполненным m_verb и m_path.
+        void route() {
+            if (m_verb.empty() || m_path.empty()) {
+                return;
+            }
+            m_route.reserve(m_verb.size() + m_path.size() + 1);
+            for (const auto part : { m_verb, std::string_view { " " }, m_path }) {
+                for (const auto ch : part) {
+                    m_route.push_back(ch >= 'A' && ch <= 'Z' ? static_cast<char>(ch - 'A' + 'a') : ch);
+                }
+            }
+            const std::string_view text { m_route };
+            m_hint.reserve(c_hintsReserve);
+            for (auto first = text.find_first_not_of(c_hintDelimiters); first != std::string_view::npos;) {
+                const auto last = text.find_first_of(c_hintDelimiters, first);
+                m_hint.emplace_back(text.substr(first, last - first));
+                first = text.find_first_not_of(c_hintDelimiters, last);
+            }
+        }
+
+        // Значение параметра строки запроса; для отсутствующего параметра и параметра без значения - пустое.
+        [[nodiscard]]
+        std::string_view parameter(const std::string_view name) const noexcept {
+            for (std::string_view rest { m_query }; !rest.empty();) {
+                const auto end = rest.find('&');
+                const auto pair = rest.substr(0, end);
+                rest = end == std::string_view::npos ? std::string_view {} : rest.substr(end + 1);
+                if (const auto equals = pair.find('='); pair.substr(0, equals) == name) {
+                    return equals == std::string_view::npos ? std::string_view {} : pair.substr(equals + 1);
+                }
+            }
+            return {};
+        }
+
         [[nodiscard]]
         bool emptyResponse() const {
             return m_response.m_data.index() == 0
@@ -6,13 +6,11 @@
 #include "http_types.h"
 #include "http_strings.h"
 #include "http_proto_response.h"
-#include <lib/meta.h>
 #include <lib/json.h>
 #include <cassert>
 #include <memory>
 #include <variant>
-#include <ostream>
-#include <format>
+#include <string>
 
 namespace Http {
     struct Response {
@@ -27,9 +25,14 @@ namespace Http {
         Response & operator=(const Response &) = delete;
         Response & operator=(Response &&) = delete;
 
-        void render(Asio::StreamBuffer & buffer) {
+        [[nodiscard]]
+        bool keepAliveReady() const noexcept {
+            return m_data.index() != 2 || std::get<2>(m_data)->keepAliveReady();
+        }
+
+        void render(Wire & wire, const bool keepAlive) {
             if (m_data.index() == 2) {
-                std::get<2>(m_data)->render(buffer, m_status);
+                std::get<2>(m_data)->render(wire, m_status, keepAlive);
             } else {
                 assert(Mbs::c_statusStrings.contains(m_status));
                 const Nln::Json json(
@@ -46,17 +49,7 @@ namespace Http {
                     false,
                     Nln::EmptyJsonObject
                 );
-                const std::string text { json.dump() };
-                std::ostream output { &buffer };
-                output
-                    << std::format(
-                        Mbs::c_responseHeaderTemplate,
-                        Meta::toUnderlying(m_status),
-                        Mbs::c_statusStrings.at(m_status),
-                        Mbs::c_jsonMimeType,
-                        text.size()
-                    )
-                    << text;
+                renderBody(wire, m_status, keepAlive, true, Mbs::c_jsonMimeType, json.dump());
             }
         }
     };
@@ -0,0 +1,222 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#pragma once
+
+#include "http_types.h"
+#include <cstddef>
+#include <charconv>
+#include <array>
+#include <string_view>
+
+namespace Http {
+    // Инкрементальный разбор запроса поверх непрерывного буфера приёма. Сканер ничего не копирует
+    // и не выделяет память: он запоминает смещения элементов запроса от начала буфера, поэтому буфер
+    // может перераспределяться между вызовами feed(). Представления строятся по смещениям после разбора.
+    class Scanner {
+    public:
+        enum class Result { Partial, Complete, BadRequest, NotImplemented, BodyTooLarge };
+
+        struct Span {
+            size_t m_offset { 0 };
+            size_t m_size { 0 };
+
+            [[nodiscard]]
+            std::string_view view(const std::string_view data) const noexcept {
+                return data.substr(m_offset, m_size);
+            }
+        };
+
+        struct FieldSpans {
+            Span m_name {};
+            Span m_value {};
+            Field m_field { Field::Other };
+        };
+
+        static constexpr size_t c_fieldsLimit { 64 };
+
+    private:
+        enum class Stage { RequestLine, Fields, Body, Done };
+
+        static constexpr std::string_view c_spaces { " \t\r" };
+
+        std::array<FieldSpans, c_fieldsLimit> m_fields {};
+        size_t m_fieldCount { 0 };
+        size_t m_position { 0 };
+        size_t m_searched { 0 }; // До этой позиции перевода строки в буфере уже нет
+        size_t m_contentLength { 0 };
+        bool m_hasContentLength { false };
+        size_t m_bodyLimit;
+        Span m_verb {};
+        Span m_target {};
+        Span m_query {};
+        Span m_version {};
+        Span m_body {};
+        Method m_method { Method::NotImplemented };
+        Stage m_stage { Stage::RequestLine };
+        Result m_result { Result::Partial };
+
+        [[nodiscard]]
+        static Span trimmed(const std::string_view data, size_t first, size_t last) noexcept {
+            while (first < last && c_spaces.find(data[first]) != std::string_view::npos) {
+                ++first;
+            }
+            while (last > first && c_spaces.find(data[last - 1]) != std::string_view::npos) {
+                --last;
+            }
+            return { first, last - first };
+        }
+
+        void fail(const Result result) noexcept {
+            m_stage = Stage::Done;
+            m_result = result;
+        }
+
+        void scanRequestLine(const std::string_view data, const size_t first, const size_t last) noexcept {
+            const auto line = data.substr(0, last);
+            const auto verbEnd = line.find(' ', first);
+            if (verbEnd == std::string_view::npos || verbEnd == first) {
+                return fail(Result::BadRequest);
+            }
+            m_verb = { first, verbEnd - first };
+
+            const auto targetEnd = line.find_first_of(" ?#\r", verbEnd + 1);
+            if (targetEnd == std::string_view::npos || targetEnd == verbEnd + 1) {
+                return fail(Result::BadRequest);
+            }
+            m_target = { verbEnd + 1, targetEnd - verbEnd - 1 };
+
+            if (line[targetEnd] == '?') {
+                const auto queryEnd = line.find_first_of(" #\r", targetEnd + 1);
+                m_query = { targetEnd + 1, (queryEnd == std::string_view::npos ? last : queryEnd) - targetEnd - 1 };
+            }
+
+            const auto versionBegin = line.rfind(' ');
+            if (versionBegin != std::string_view::npos && versionBegin >= targetEnd) {
+                m_version = trimmed(data, versionBegin + 1, last);
+            }
+
+            const auto verb = m_verb.view(data);
+            if (equalsIgnoreCase(verb, "get")) {
+                m_method = Method::Get;
+            } else if (equalsIgnoreCase(verb, "post")) {
+                m_method = Method::Post;
+            } else {
+                return fail(Result::NotImplemented);
+            }
+
+            m_stage = Stage::Fields;
+        }
+
+        void scanField(const std::string_view data, const size_t first, const size_t last) noexcept {
+            const auto separator = data.find(':', first);
+            if (separator == std::string_view::npos || separator >= last) {
+                return fail(Result::BadRequest);
+            }
+            if (m_fieldCount == m_fields.size()) {
+                return fail(Result::BadRequest);
+            }
+
+            FieldSpans field { trimmed(data, first, separator), trimmed(data, separator + 1, last) };
+            if (field.m_name.m_size == 0) {
+                return fail(Result::BadRequest);
+            }
+            field.m_field = classify(field.m_name.view(data));
+            m_fields[m_fieldCount++] = field;
+
+            // Тело с иной разметкой не поддерживается. Оставить его в буфере нельзя: при конвейерной
+            // обработке оно было бы разобрано как следующий запрос.
+            if (field.m_field == Field::Other && equalsIgnoreCase(field.m_name.view(data), "transfer-encoding")) {
+                return fail(Result::NotImplemented);
+            }
+
+            if (field.m_field == Field::ContentLength) {
+                // Повторный Content-Length (даже с тем же значением) делает границу тела неоднозначной.
+                if (m_hasContentLength) {
+                    return fail(Result::BadRequest);
+                }
+                m_hasContentLength = true;
+                const auto value = field.m_value.view(data);
+                size_t length { 0 };
+                const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), length);
+                if (ec != std::errc {} || ptr != value.data() + value.size()) {
+                    return fail(Result::BadRequest);
+                }
+                if (length > m_bodyLimit) {
+                    return fail(Result::BodyTooLarge);
+                }
+                m_contentLength = length;
+            }
+        }
+
+    public:
+        Scanner() = delete;
+        Scanner(const Scanner &) = delete;
+        Scanner(Scanner &&) = delete;
+        explicit Scanner(const size_t bodyLimit) noexcept : m_bodyLimit(bodyLimit) {}
+        ~Scanner() = default;
+
+        Scanner & operator=(const Scanner &) = delete;
+        Scanner & operator=(Scanner &&) = delete;
+
+        // data - всё содержимое буфера от начала запроса. Каждый следующий вызов должен получать
+        // как минимум те же байты, что и предыдущий, с возможным продолжением.
+        Result feed(const std::string_view data) noexcept {
+            while (m_stage == Stage::RequestLine || m_stage == Stage::Fields) {
+                // Длинная строка, поступающая частями, не просматривается заново с начала.
+                const auto newline = data.find('\n', m_searched > m_position ? m_searched : m_position);
+                if (newline == std::string_view::npos) {
+                    m_searched = data.size();
+                    return m_result;
+                }
+                const auto first = m_position;
+                const auto last = newline > first && data[newline - 1] == '\r' ? newline - 1 : newline;
+                m_position = newline + 1;
+
+                if (m_stage == Stage::RequestLine) {
+                    if (first == last) {
+                        // Допускаем пустые строки перед строкой запроса (RFC 9112, п. 2.2).
+                        continue;
+                    }
+                    scanRequestLine(data, first, last);
+                } else if (first == last) {
+                    // Тело отделяется по Content-Length при любом методе, даже если обработчик его не читает.
+                    m_body = { m_position, m_contentLength };
+                    m_stage = Stage::Body;
+                } else {
+                    scanField(data, first, last);
+                }
+            }
+
+            if (m_stage == Stage::Body && data.size() >= m_body.m_offset + m_body.m_size) {
+                m_stage = Stage::Done;
+                m_result = Result::Complete;
+            }
+
+            return m_result;
+        }
+
+        [[nodiscard]] Result result() const noexcept { return m_result; }
+        [[nodiscard]] Method method() const noexcept { return m_method; }
+
+        // Количество байт тела, которых ещё не хватает в буфере.
+        [[nodiscard]]
+        size_t expecting(const size_t available) const noexcept {
+            if (m_stage != Stage::Body || available >= m_body.m_offset + m_body.m_size) {
+                return 0;
+            }
+            return m_body.m_offset + m_body.m_size - available;
+        }
+
+        // Размер запроса в буфере вместе с телом; следующие байты относятся к следующему запросу.
+        [[nodiscard]] size_t consumed() const noexcept { return m_body.m_offset + m_body.m_size; }
+
+        [[nodiscard]] Span verb() const noexcept { return m_verb; }
+        [[nodiscard]] Span target() const noexcept { return m_target; }
+        [[nodiscard]] Span query() const noexcept { return m_query; }
+        [[nodiscard]] Span version() const noexcept { return m_version; }
+        [[nodiscard]] Span body() const noexcept { return m_body; }
+        [[nodiscard]] size_t fieldCount() const noexcept { return m_fieldCount; }
+        [[nodiscard]] const FieldSpans & field(const size_t index) const noexcept { return m_fields[index]; }
+    };
+}
@@ -0,0 +1,146 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#pragma once
+
+#include "http_types.h"
+#include "http_strings.h"
+#include "http_proto_response.h"
+#include <cassert>
+#include <utility>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace Http {
+    // Неизменяемый ответ, сериализованный один раз (статусная строка, заголовки и тело). Байты хранятся
+    // в варианте для keep-alive, строка 'Connection' идёт сразу за статусной строкой, поэтому для закрываемого
+    // соединения подменяется только короткий заголовок, а остальное отдаётся без копирования. Если тело
+    // сжимаемо, рядом хранится сжатый вариант, и повторные ответы не тратят время на сжатие.
+    // m_varied - выбирался ли вариант по Accept-Encoding (в заголовке есть 'Vary'); нужен ответу 304.
+    struct SerializedResponse final : ProtoResponse {
+        static constexpr std::string_view c_headEnd { "\r\n\r\n" };
+
+        struct Bytes {
+            std::string m_bytes {};
+            size_t m_statusLineSize { 0 };
+        };
+
+        const Bytes m_plain;
+        const Bytes m_gzipped;
+        const bool m_keepAliveReady;
+        const bool m_varied;
+
+        SerializedResponse() = delete;
+
+        SerializedResponse(Bytes && plain, Bytes && gzipped, const bool keepAliveReady)
+        : ProtoResponse(), m_plain { std::forward<Bytes>(plain) }, m_gzipped { std::forward<Bytes>(gzipped) },
+          m_keepAliveReady { keepAliveReady }, m_varied { varied(m_plain.m_bytes) } {}
+
+        SerializedResponse(const SerializedResponse &) = delete;
+        SerializedResponse(SerializedResponse &&) = delete;
+        ~SerializedResponse() override = default;
+
+        SerializedResponse & operator=(const SerializedResponse &) = delete;
+        SerializedResponse & operator=(SerializedResponse &&) = delete;
+
+        // Объём памяти, занимаемый сериализованными байтами.
+        [[nodiscard]]
+        size_t memoryUsage() const noexcept {
+            return sizeof(*this) + m_plain.m_bytes.capacity() + m_gzipped.m_bytes.capacity();
+        }
+
+        [[nodiscard]]
+        static bool varied(const std::string_view bytes) noexcept {
+            return bytes.substr(0, bytes.find(c_headEnd)).find(Mbs::c_varyHeader) != std::string_view::npos;
+        }
+
+        [[nodiscard]]
+        static Bytes serialize(const Wire & wire, const bool keepAliveReady) {
+            Bytes result {};
+            result.m_bytes.reserve(wire.size());
+            for (const auto & buffer : wire.buffers()) {
+                result.m_bytes.append(static_cast<const char *>(buffer.data()), buffer.size());
+            }
+            if (keepAliveReady) {
+                result.m_statusLineSize = result.m_bytes.find(Mbs::c_crlf);
+                assert(result.m_statusLineSize != std::string::npos);
+                result.m_statusLineSize += Mbs::c_crlf.size();
+                assert(
+                    std::string_view(result.m_bytes).substr(result.m_statusLineSize)
+                        .starts_with(Mbs::c_connectionKeepAlive)
+                );
+            }
+            return result;
+        }
+
+        // gzipThreshold - порог сжатия; при нулевом пороге сжатый вариант не готовится.
+        [[nodiscard]]
+        static std::shared_ptr<SerializedResponse> from(
+            ProtoResponse & response,
+            const Status status,
+            const size_t gzipThreshold = 0
+        ) {
+            const bool keepAliveReady { response.keepAliveReady() };
+            Bytes plain {}, gzipped {};
+
+            {
+                Wire wire {};
+                wire.negotiateGzip(gzipThreshold, false);
+                response.render(wire, status, keepAliveReady);
+                plain = serialize(wire, keepAliveReady);
+            }
+
+            if (gzipThreshold > 0) {
+                Wire wire {};
+                wire.negotiateGzip(gzipThreshold, true);
+                response.render(wire, status, keepAliveReady);
+                if (wire.gzipped()) {
+                    gzipped = serialize(wire, keepAliveReady);
+                }
+            }
+
+            return std::make_shared<SerializedResponse>(std::move(plain), std::move(gzipped), keepAliveReady);
+        }
+
+        explicit operator bool() override {
+            return !m_plain.m_bytes.empty();
+        }
+
+        [[nodiscard]]
+        bool keepAliveReady() const noexcept override {
+            return m_keepAliveReady;
+        }
+
+        void render(Wire & wire, Status, const bool keepAlive) override {
+            const auto & variant = wire.gzipAccepted() && !m_gzipped.m_bytes.empty() ? m_gzipped : m_plain;
+            const std::string_view bytes { variant.m_bytes };
+            if (keepAlive || !m_keepAliveReady) {
+                wire.body(bytes);
+            } else {
+                wire.head().append(bytes.substr(0, variant.m_statusLineSize)).append(Mbs::c_connectionClose);
+                wire.body(bytes.substr(variant.m_statusLineSize + Mbs::c_connectionKeepAlive.size()));
+            }
+        }
+
+        // То же с дополнительными строками заголовка (каждая с CRLF) сразу после статусной строки. Заголовок
+        // копируется в Wire целиком, чтобы Wire::parts() разделял его и тело; тело отдаётся без копирования.
+        void render(Wire & wire, const bool keepAlive, const std::string_view extraHeaders) {
+            const auto & variant = wire.gzipAccepted() && !m_gzipped.m_bytes.empty() ? m_gzipped : m_plain;
+            const std::string_view bytes { variant.m_bytes };
+            const auto statusLineEnd = bytes.find(Mbs::c_crlf) + Mbs::c_crlf.size();
+            const auto headEnd = bytes.find(c_headEnd) + c_headEnd.size();
+            assert(statusLineEnd >= Mbs::c_crlf.size() && headEnd >= c_headEnd.size());
+            auto fields = bytes.substr(statusLineEnd, headEnd - statusLineEnd);
+            auto & head = wire.head();
+            head.reserve(headEnd + extraHeaders.size());
+            head.append(bytes.substr(0, statusLineEnd)).append(extraHeaders);
+            if (m_keepAliveReady && !keepAlive) {
+                head.append(Mbs::c_connectionClose);
+                fields.remove_prefix(Mbs::c_connectionKeepAlive.size());
+            }
+            head.append(fields);
+            wire.body(bytes.substr(headEnd));
+        }
+    };
+}
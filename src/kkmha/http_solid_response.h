@@ -6,7 +6,8 @@
 #include "http_types.h"
 #include "http_proto_response.h"
 #include <utility>
-#include <ostream>
+#include <string>
+#include <string_view>
 
 namespace Http {
     struct SolidResponse final : ProtoResponse {
@@ -33,9 +34,13 @@ namespace Http {
             return !m_data.empty();
         }
 
-        void render(Asio::StreamBuffer & buffer, Status) override {
-            std::ostream output { &buffer };
-            output << m_data;
+        [[nodiscard]]
+        bool keepAliveReady() const noexcept override {
+            return false; // Заголовок 'Connection: close' уже содержится в m_data
+        }
+
+        void render(Wire & wire, Status, bool) override {
+            wire.body(m_data);
         }
     };
 }
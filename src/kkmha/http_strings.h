@@ -21,27 +21,29 @@ namespace Http {
         constexpr Csv c_bodySizeLimitExceeded { "Превышен разрешенный размер тела запроса" };
         constexpr Csv c_jsonMimeType { "application/json" };
 
-        constexpr Csv c_responseHeaderTemplate {
-            "HTTP/1.1 {} {}\r\n"
-            "Connection: close\r\n"
-            "Pragma: no-cache\r\n"
-            "Cache-Control: no-cache, private\r\n"
-            "Content-Type: {}\r\n"
-            "Content-Length: {}\r\n"
-            "\r\n"
-        };
-
-        constexpr Csv c_staticResponseHeaderTemplate {
-            "HTTP/1.1 {} {}\r\n"
-            "Connection: close\r\n"
-            "Content-Type: {}\r\n"
-            "Content-Length: {}\r\n"
-            "\r\n"
-        };
+        constexpr Csv c_connectionClose { "Connection: close\r\n" };
+        constexpr Csv c_connectionKeepAlive { "Connection: keep-alive\r\n" };
+
+        constexpr Csv c_crlf { "\r\n" };
+        constexpr Csv c_statusLinePrefix { "HTTP/1.1 " };
+        constexpr Csv c_noCacheHeaders { "Pragma: no-cache\r\nCache-Control: no-cache, private\r\n" };
+        constexpr Csv c_contentTypePrefix { "Content-Type: " };
+        constexpr Csv c_contentLengthPrefix { "Content-Length: " };
+        constexpr Csv c_gzipHeader { "Content-Encoding: gzip\r\n" };
+        constexpr Csv c_varyHeader { "Vary: Accept-Encoding\r\n" };
+        constexpr Csv c_agePrefix { "Age: " };
+        constexpr Csv c_etagPrefix { "ETag: " };
+        constexpr Csv c_gzipTagSuffix { "-gz" };
+
+        [[nodiscard, maybe_unused]]
+        constexpr std::string_view connection(const bool keepAlive) {
+            return keepAlive ? c_connectionKeepAlive : c_connectionClose;
+        }
 
         inline const std::unordered_map<Status, std::string> c_statusStrings {
             { Status::Ok, Basic::Mbs::c_ok },
             { Status::MovedTemporarily, "Moved Temporarily" },
+            { Status::NotModified, "Not Modified" },
             { Status::BadRequest, "Bad Request" },
             // { Status::Unauthorized, "Unauthorized" },
             { Status::Forbidden, "Forbidden" },
@@ -51,7 +53,7 @@ namespace Http {
             // { Status::ImATeapot, "I’m a teapot" },
             { Status::InternalServerError, "Internal Server Error" },
             { Status::NotImplemented, "Not Implemented" },
-            // { Status::ServiceUnavailable, "Service Unavailable" },
+            { Status::ServiceUnavailable, "Service Unavailable" },
             // { Status::UnknownError, "Unknown Error" },
         };
     }
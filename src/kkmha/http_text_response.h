@@ -0,0 +1,38 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#pragma once
+
+#include "http_types.h"
+#include "http_proto_response.h"
+#include <utility>
+#include <string>
+#include <string_view>
+
+namespace Http {
+    struct TextResponse final : ProtoResponse {
+        std::string m_mimeType;
+        std::string m_data;
+
+        TextResponse() = delete;
+
+        [[maybe_unused]]
+        TextResponse(std::string && data, const std::string_view mimeType)
+        : ProtoResponse(), m_mimeType { mimeType }, m_data { std::forward<std::string>(data) } {}
+
+        TextResponse(const TextResponse &) = delete;
+        TextResponse(TextResponse &&) = delete;
+        ~TextResponse() override = default;
+
+        TextResponse & operator=(const TextResponse &) = delete;
+        TextResponse & operator=(TextResponse &&) = delete;
+
+        explicit operator bool() override {
+            return !m_data.empty();
+        }
+
+        void render(Wire & wire, const Status status, const bool keepAlive) override {
+            renderBody(wire, status, keepAlive, true, m_mimeType, m_data);
+        }
+    };
+}
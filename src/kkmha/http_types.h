@@ -3,17 +3,122 @@
 
 #pragma once
 
-#include <string>
-#include <unordered_map>
+#include <lib/hash.h>
+#include <cassert>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <array>
+#include <bitset>
+#include <vector>
+#include <memory_resource>
 
 namespace Http {
-    using Header = std::unordered_map<std::string, std::string>;
+    [[nodiscard]]
+    constexpr bool equalsIgnoreCase(const std::string_view text, const std::string_view lowered) noexcept {
+        if (text.size() != lowered.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (Hash::lowered(text[i]) != lowered[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Поля заголовка, которые читает сервер. Порядок совпадает с c_knownFields.
+    enum class Field : uint8_t {
+        AcceptEncoding,
+        Connection,
+        ContentLength,
+        ContentType,
+        XIdempotencyKey,
+        XSecret,
+        Other
+    };
+
+    constexpr size_t c_knownFieldCount { static_cast<size_t>(Field::Other) };
+
+    constexpr Hash::Perfect<c_knownFieldCount> c_knownFields {
+        std::array<std::string_view, c_knownFieldCount> {
+            "accept-encoding", "connection", "content-length", "content-type", "x-idempotency-key", "x-secret"
+        }
+    };
+
+    [[nodiscard]]
+    constexpr Field classify(const std::string_view name) noexcept {
+        return static_cast<Field>(c_knownFields.find(name));
+    }
+
+    // Известные поля заголовка раскладываются по слотам при разборе, остальные хранятся в порядке
+    // поступления и ищутся линейно без учёта регистра. Имена и значения ссылаются на буфер приёма запроса.
+    class Header {
+    public:
+        using Other = std::pair<std::string_view, std::string_view>;
+        using Others = std::pmr::vector<Other>;
+        using const_iterator = Others::const_iterator;
+
+    private:
+        std::array<std::string_view, c_knownFieldCount> m_known {};
+        std::bitset<c_knownFieldCount> m_present {};
+        Others m_others {};
+
+    public:
+        explicit Header(std::pmr::memory_resource * resource = std::pmr::get_default_resource())
+        : m_others(resource) {}
+
+        void reserve(const size_t size) { m_others.reserve(size); }
+
+        void emplace(const Field field, const std::string_view name, const std::string_view value) {
+            if (field == Field::Other) {
+                m_others.emplace_back(name, value);
+            } else {
+                m_known[static_cast<size_t>(field)] = value;
+                m_present.set(static_cast<size_t>(field));
+            }
+        }
+
+        void clear() noexcept {
+            m_known.fill({});
+            m_present.reset();
+            m_others.clear();
+        }
+
+        [[nodiscard]]
+        bool has(const Field field) const noexcept {
+            assert(field != Field::Other);
+            return m_present.test(static_cast<size_t>(field));
+        }
+
+        // Значение известного поля; для отсутствующего поля - пустая строка.
+        [[nodiscard]]
+        std::string_view operator[](const Field field) const noexcept {
+            assert(field != Field::Other);
+            return m_known[static_cast<size_t>(field)];
+        }
+
+        // Поиск среди прочих полей, name - в нижнем регистре.
+        [[nodiscard]]
+        const_iterator find(const std::string_view name) const noexcept {
+            for (auto it = m_others.begin(); it != m_others.end(); ++it) {
+                if (equalsIgnoreCase(it->first, name)) {
+                    return it;
+                }
+            }
+            return m_others.end();
+        }
+
+        [[nodiscard]] const_iterator begin() const noexcept { return m_others.begin(); }
+        [[nodiscard]] const_iterator end() const noexcept { return m_others.end(); }
+    };
 
     enum class Method { NotImplemented, Get, Post };
 
     enum class Status {
         Ok = 200,
         MovedTemporarily = 302,
+        NotModified = 304,
         BadRequest = 400,
         // Unauthorized,
         Forbidden = 403,
@@ -23,7 +128,7 @@ namespace Http {
         // ImATeapot = 418,
         InternalServerError = 500,
         NotImplemented,
-        // ServiceUnavailable = 503,
+        ServiceUnavailable = 503,
         // UnknownError = 520,
     };
 }
@@ -0,0 +1,214 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#pragma once
+
+#include "http_types.h"
+#include "http_strings.h"
+#include "http_gzip.h"
+#include "asio.h"
+#include <lib/meta.h>
+#include <cassert>
+#include <utility>
+#include <array>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <type_traits>
+
+namespace Http {
+    // Ответ, подготовленный к отправке: заголовок и тело передаются в async_write отдельными буферами,
+    // без склейки в общий буфер. Тело либо принадлежит Wire, либо ссылается на память ответа, который
+    // обязан жить до завершения записи. Если клиент принимает gzip, ответ может сжать тело, когда оно
+    // не меньше порога сжатия. Ответ, кодирование которого выбиралось по Accept-Encoding, сжат он или нет,
+    // получает заголовок 'Vary', иначе разделяемый кэш отдаст один вариант всем клиентам.
+    class Wire {
+        std::string m_head {};
+        std::string m_ownBody {};
+        std::string_view m_body {};
+        size_t m_gzipThreshold { 0 };
+        bool m_gzipAccepted { false };
+        bool m_gzipped { false };
+
+    public:
+        using Buffers = std::array<asio::const_buffer, 2>;
+
+        Wire() = default;
+        Wire(const Wire &) = delete;
+        Wire(Wire &&) = delete;
+        ~Wire() = default;
+
+        Wire & operator=(const Wire &) = delete;
+        Wire & operator=(Wire &&) = delete;
+
+        [[nodiscard]]
+        std::string & head() noexcept {
+            return m_head;
+        }
+
+        // threshold - порог сжатия (0 - сжатие отключено), accepted - принимает ли клиент gzip.
+        void negotiateGzip(const size_t threshold, const bool accepted) noexcept {
+            m_gzipThreshold = threshold;
+            m_gzipAccepted = accepted && threshold > 0;
+        }
+
+        [[nodiscard]]
+        bool gzipAccepted() const noexcept {
+            return m_gzipAccepted;
+        }
+
+        // Выбирается ли кодирование тела по Accept-Encoding, то есть зависит ли ответ от этого поля.
+        [[nodiscard]]
+        bool gzipNegotiable(const std::string_view mimeType, const size_t size) const noexcept {
+            return m_gzipThreshold > 0 && size >= m_gzipThreshold && Gzip::compressible(mimeType);
+        }
+
+        [[nodiscard]]
+        bool gzipWanted(const std::string_view mimeType, const size_t size) const noexcept {
+            return m_gzipAccepted && gzipNegotiable(mimeType, size);
+        }
+
+        [[nodiscard]]
+        bool gzipped() const noexcept {
+            return m_gzipped;
+        }
+
+        void gzipped(std::string && data) noexcept {
+            m_gzipped = true;
+            body(std::forward<std::string>(data));
+        }
+
+        void body(const std::string_view data) noexcept {
+            m_body = data;
+        }
+
+        void body(std::string && data) noexcept {
+            m_ownBody = std::forward<std::string>(data);
+            m_body = m_ownBody;
+        }
+
+        [[nodiscard]]
+        Buffers buffers() const noexcept {
+            return { asio::buffer(m_head), asio::buffer(m_body.data(), m_body.size()) };
+        }
+
+        // Заголовок и тело по отдельности, даже если ответ целиком передан телом (см. SerializedResponse).
+        [[nodiscard]]
+        std::pair<std::string_view, std::string_view> parts() const noexcept {
+            if (!m_head.empty()) {
+                return { m_head, m_body };
+            }
+            const auto end = m_body.find("\r\n\r\n");
+            if (end == std::string_view::npos) {
+                return { {}, m_body };
+            }
+            return { m_body.substr(0, end + 4), m_body.substr(end + 4) };
+        }
+
+        [[nodiscard]]
+        size_t size() const noexcept {
+            return m_head.size() + m_body.size();
+        }
+    };
+
+    inline void appendNumber(std::string & output, const size_t value) {
+        std::array<char, 24> digits {};
+        auto [end, error] = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+        assert(error == std::errc {});
+        output.append(digits.data(), end);
+    }
+
+    // Строгий валидатор различает кодирования (RFC 9110, п. 8.8.3): у сжатого варианта перед закрывающей
+    // кавычкой добавляется суффикс.
+    [[nodiscard]]
+    inline std::string codedTag(const std::string_view tag, const bool gzipped) {
+        if (!gzipped || tag.size() < 2 || tag.back() != '"') {
+            return std::string { tag };
+        }
+        std::string result {};
+        result.reserve(tag.size() + Mbs::c_gzipTagSuffix.size());
+        result.append(tag.substr(0, tag.size() - 1)).append(Mbs::c_gzipTagSuffix).push_back('"');
+        return result;
+    }
+
+    // tag - строгий валидатор (ETag) несжатого варианта; пустой - без заголовка 'ETag'.
+    inline void renderHead(
+        std::string & head,
+        const Status status,
+        const bool keepAlive,
+        const bool noCache,
+        const std::string_view mimeType,
+        const size_t contentLength,
+        const bool gzipped = false,
+        const std::string_view extraHeaders = {},
+        const bool varied = false,
+        const std::string_view tag = {}
+    ) {
+        assert(Mbs::c_statusStrings.contains(status));
+        const auto & reason = Mbs::c_statusStrings.at(status);
+        head.reserve(head.size() + 160 + reason.size() + mimeType.size() + extraHeaders.size() + tag.size());
+        head.append(Mbs::c_statusLinePrefix);
+        appendNumber(head, static_cast<size_t>(Meta::toUnderlying(status)));
+        head.push_back(' ');
+        head.append(reason);
+        head.append(Mbs::c_crlf);
+        head.append(Mbs::connection(keepAlive));
+        if (noCache) {
+            head.append(Mbs::c_noCacheHeaders);
+        }
+        head.append(extraHeaders);
+        if (!tag.empty()) {
+            head.append(Mbs::c_etagPrefix);
+            head.append(codedTag(tag, gzipped));
+            head.append(Mbs::c_crlf);
+        }
+        head.append(Mbs::c_contentTypePrefix);
+        head.append(mimeType);
+        head.append(Mbs::c_crlf);
+        if (gzipped) {
+            head.append(Mbs::c_gzipHeader);
+        }
+        if (gzipped || varied) {
+            head.append(Mbs::c_varyHeader);
+        }
+        head.append(Mbs::c_contentLengthPrefix);
+        appendNumber(head, contentLength);
+        head.append(Mbs::c_crlf);
+        head.append(Mbs::c_crlf);
+    }
+
+    // Заголовок и тело ответа; тело сжимается, если клиент принимает gzip, а тип и размер тела подходят.
+    // extraHeaders - дополнительные строки заголовка, каждая с CRLF; tag - валидатор, см. renderHead().
+    template<typename T>
+    requires std::is_same_v<std::remove_cvref_t<T>, std::string>
+             || std::is_same_v<std::remove_cvref_t<T>, std::string_view>
+    void renderBody(
+        Wire & wire,
+        const Status status,
+        const bool keepAlive,
+        const bool noCache,
+        const std::string_view mimeType,
+        T && data,
+        const std::string_view extraHeaders = {},
+        const std::string_view tag = {}
+    ) {
+        if (wire.gzipWanted(mimeType, data.size())) {
+            if (auto packed = Gzip::compress(data); !packed.empty()) {
+                renderHead(
+                    wire.head(), status, keepAlive, noCache, mimeType, packed.size(), true, extraHeaders, true, tag
+                );
+                wire.gzipped(std::move(packed));
+                return;
+            }
+        }
+        const bool varied { wire.gzipNegotiable(mimeType, data.size()) };
+        renderHead(
+            wire.head(), status, keepAlive, noCache, mimeType, data.size(), false, extraHeaders, varied, tag
+        );
+        if constexpr (std::is_same_v<T, std::string>) {
+            wire.body(std::forward<T>(data));
+        } else {
+            wire.body(std::string_view { data });
+        }
+    }
+}
@@ -0,0 +1,144 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#pragma once
+
+#include "asio.h"
+#include <algorithm>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <deque>
+
+namespace Server {
+    // Допуск соединений к обслуживанию. Пока занято меньше limit слотов, соединение допускается сразу,
+    // иначе ждёт в очереди FIFO не дольше maxWait. Освободившийся слот передаётся первому ожидающему.
+    // Ожидание можно привязать к сигналу отмены и сроку запроса: по любому из них соединение покидает
+    // очередь, а не держит в ней место до выдачи слота.
+    class Admission {
+    public:
+        enum class Verdict { Admitted, Overflow, Timeout, Canceled };
+
+        struct Stats {
+            int64_t m_active;
+            int64_t m_queueDepth;
+            int64_t m_queuePeak;
+            uint64_t m_admitted;
+            uint64_t m_queued;
+            uint64_t m_overflows;
+            uint64_t m_timeouts;
+            uint64_t m_cancellations;
+        };
+
+    private:
+        struct Waiter {
+            Asio::Timer m_timer;
+            bool m_granted { false };
+
+            explicit Waiter(const Asio::Executor & executor) : m_timer { executor } {}
+        };
+
+        std::mutex m_mutex {};
+        std::deque<std::shared_ptr<Waiter>> m_queue {};
+        int64_t m_active { 0 };
+        std::atomic<int64_t> m_queuePeak { 0 };
+        std::atomic<uint64_t> m_admitted { 0 };
+        std::atomic<uint64_t> m_queued { 0 };
+        std::atomic<uint64_t> m_overflows { 0 };
+        std::atomic<uint64_t> m_timeouts { 0 };
+        std::atomic<uint64_t> m_cancellations { 0 };
+
+    public:
+        Admission() = default;
+        Admission(const Admission &) = delete;
+        Admission(Admission &&) = delete;
+        ~Admission() = default;
+
+        Admission & operator=(const Admission &) = delete;
+        Admission & operator=(Admission &&) = delete;
+
+        // slot - слот отмены соединения, deadline - срок, после которого ждать бессмысленно.
+        asio::awaitable<Verdict> enter(
+            const int64_t limit,
+            const int64_t queueLimit,
+            const std::chrono::seconds maxWait,
+            const asio::cancellation_slot slot = {},
+            const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max()
+        ) {
+            auto waiter = std::make_shared<Waiter>(co_await asio::this_coro::executor);
+
+            {
+                std::scoped_lock lock { m_mutex };
+                if (m_active < limit) {
+                    ++m_active;
+                    ++m_admitted;
+                    co_return Verdict::Admitted;
+                }
+                if (static_cast<int64_t>(m_queue.size()) >= queueLimit) {
+                    ++m_overflows;
+                    co_return Verdict::Overflow;
+                }
+                waiter->m_timer.expires_at(std::min(std::chrono::steady_clock::now() + maxWait, deadline));
+                m_queue.push_back(waiter);
+                ++m_queued;
+                if (static_cast<int64_t>(m_queue.size()) > m_queuePeak) {
+                    m_queuePeak = static_cast<int64_t>(m_queue.size());
+                }
+            }
+
+            // Таймер прерывается из leave() при передаче слота, поэтому слот выдан, только если выставлен флаг
+            // m_granted (проверяется под мьютексом). Иначе прерванное ожидание означает отмену соединения.
+            const auto [error]
+                = co_await waiter->m_timer.async_wait(
+                    asio::bind_cancellation_slot(slot, asio::as_tuple(asio::use_awaitable))
+                );
+
+            std::scoped_lock lock { m_mutex };
+            if (waiter->m_granted) {
+                ++m_admitted;
+                co_return Verdict::Admitted;
+            }
+            std::erase(m_queue, waiter);
+            if (error == asio::error::operation_aborted) {
+                ++m_cancellations;
+                co_return Verdict::Canceled;
+            }
+            ++m_timeouts;
+            co_return Verdict::Timeout;
+        }
+
+        void leave() {
+            std::shared_ptr<Waiter> next {};
+
+            {
+                std::scoped_lock lock { m_mutex };
+                if (m_queue.empty()) {
+                    --m_active;
+                    return;
+                }
+                next = std::move(m_queue.front());
+                m_queue.pop_front();
+                next->m_granted = true;
+            }
+
+            // Таймер не потокобезопасен, поэтому прерываем ожидание в потоке его реактора.
+            asio::post(next->m_timer.get_executor(), [next] { next->m_timer.cancel(); });
+        }
+
+        [[nodiscard]]
+        Stats stats() {
+            std::scoped_lock lock { m_mutex };
+            return {
+                .m_active = m_active,
+                .m_queueDepth = static_cast<int64_t>(m_queue.size()),
+                .m_queuePeak = m_queuePeak.load(),
+                .m_admitted = m_admitted.load(),
+                .m_queued = m_queued.load(),
+                .m_overflows = m_overflows.load(),
+                .m_timeouts = m_timeouts.load(),
+                .m_cancellations = m_cancellations.load()
+            };
+        }
+    };
+}
@@ -0,0 +1,50 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory_resource>
+
+namespace Server::Arena {
+    struct Stats {
+        uint64_t m_allocations;
+        uint64_t m_bytes;
+    };
+
+    // Арена соединения покрывает только разбор запроса: лишние поля заголовка, маршрут и подсказки. Остальное
+    // размещается в общей куче намеренно: аллокатор JSON не принимает ресурс с состоянием, а Payload, ответы
+    // и записи кэша переживают запрос (очереди ККМ, совместные обмены, кэш) и освобождаются в потоках пула,
+    // тогда как monotonic_buffer_resource однопоточный и сбрасывается перед следующим запросом.
+    // Upstream - вышестоящий ресурс арен; счётчики учитывают только его выделения, то есть случаи, когда
+    // разбору запроса не хватило начального буфера арены, а не все обращения к куче за время запроса.
+    class Upstream final : public std::pmr::memory_resource {
+        std::atomic<uint64_t> m_allocations { 0 };
+        std::atomic<uint64_t> m_bytes { 0 };
+
+        void * do_allocate(const size_t bytes, const size_t alignment) override {
+            ++m_allocations;
+            m_bytes += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void * pointer, const size_t bytes, const size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+        }
+
+        [[nodiscard]]
+        bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override {
+            return this == &other;
+        }
+
+    public:
+        [[nodiscard]]
+        Stats stats() const noexcept {
+            return { .m_allocations = m_allocations.load(), .m_bytes = m_bytes.load() };
+        }
+    };
+
+    inline Upstream s_upstream {};
+}
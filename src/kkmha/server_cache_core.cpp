@@ -2,70 +2,264 @@
 // Distributed under the MIT License, see accompanying file LICENSE.txt
 
 #include "server_cache_core.h"
+#include "server_cache_strings.h"
 #include "server_defaults.h"
-#include "server_strings.h"
+#include "server_variables.h"
+#include <lib/striped.h>
 #include <log/write.h>
 #include <utility>
+#include <algorithm>
+#include <array>
 #include <atomic>
-#include <mutex>
+#include <list>
+#include <vector>
+#include <queue>
 #include <unordered_map>
 
 namespace Server::Cache {
-    static std::unordered_map<std::string, Entry> s_cache {};
-    static std::mutex s_cacheMutex {};
-    static std::atomic<size_t> s_counter { 0 };
+    // Срок хранения записи. Записи в очереди не удаляются при замене данных: устаревший срок
+    // распознаётся при извлечении (он не совпадает со сроком текущей записи) и просто отбрасывается.
+    struct Deadline {
+        DateTime::Point m_at;
+        Key m_key;
+    };
+
+    struct Later {
+        bool operator()(const Deadline & lhs, const Deadline & rhs) const noexcept { return lhs.m_at > rhs.m_at; }
+    };
+
+    using Deadlines = std::priority_queue<Deadline, std::vector<Deadline>, Later>;
+    using Queue = std::list<const Key *>;
+
+    // Запись вместе с учётом памяти и местом в очереди вытеснения. Признак обращения выставляется
+    // при чтении под разделяемой блокировкой, поэтому попадание в кэш не перестраивает очередь:
+    // вытеснение идёт по алгоритму "второго шанса" (CLOCK), приближающему LRU.
+    struct Slot {
+        Entry m_entry;
+        size_t m_bytes;
+        Queue::iterator m_position {};
+        mutable std::atomic<bool> m_referenced { false };
+
+        Slot(Entry && entry, const size_t bytes) : m_entry { std::move(entry) }, m_bytes { bytes } {}
+
+        Slot(Slot && other) noexcept
+        : m_entry { std::move(other.m_entry) }, m_bytes { other.m_bytes }, m_position { other.m_position },
+          m_referenced { other.m_referenced.load(std::memory_order_relaxed) } {}
+    };
+
+    // Состояние полосы, защищённое её блокировкой: сроки хранения и очереди вытеснения по приоритетам.
+    struct Shelf {
+        Deadlines m_deadlines {};
+        std::array<Queue, 2> m_queues {};
+    };
+
+    using Items = std::unordered_map<Key, Slot>;
+
+    // Обработчики статики и ККМ обращаются к кэшу одновременно; при единой блокировке чтения
+    // выстраивались в очередь, теперь конкурируют только запросы к одной полосе.
+    static Striped::Map<Key, Slot, std::hash<Key>, c_cacheStripes, Shelf> s_cache {};
+
+    // Занятый объём учитывается по всему кэшу: бюджет общий для всех полос, иначе переполненная полоса
+    // вытесняла бы свои записи, пока в остальных есть место.
+    static std::atomic<size_t> s_bytes { 0 };
+    static std::atomic<size_t> s_regular { 0 }; // Число обычных (вытесняемых) записей
+    static std::atomic<bool> s_overdrawn { false };
+
+    // Стрелка CLOCK общая для всех полос: она переходит от полосы к полосе по кругу и в каждой просматривает
+    // несколько записей из начала очереди обычных записей, так что все записи кэша проходят один круг,
+    // независимо от того, в какую полосу идёт вставка. Одновременно блокируется только одна полоса.
+    static std::atomic<size_t> s_hand { 0 };
+
+    [[nodiscard]]
+    static size_t budget() noexcept {
+        return static_cast<size_t>(s_cacheMemoryLimit) * 1'048'576;
+    }
+
+    [[nodiscard]]
+    static Queue & queueOf(Shelf & shelf, const Priority priority) noexcept {
+        return shelf.m_queues[static_cast<size_t>(priority)];
+    }
+
+    static void remove(Items & items, Shelf & shelf, const Items::iterator it) {
+        const auto priority = it->second.m_entry.m_priority;
+        queueOf(shelf, priority).erase(it->second.m_position);
+        s_bytes.fetch_sub(it->second.m_bytes, std::memory_order_relaxed);
+        if (priority == Priority::Regular) {
+            s_regular.fetch_sub(1, std::memory_order_relaxed);
+        }
+        items.erase(it);
+    }
+
+    struct Advance {
+        size_t m_examined { 0 };
+        size_t m_evicted { 0 };
+    };
+
+    // Один заход стрелки в полосу: не больше c_cacheClockSteps записей и не больше одного круга по очереди
+    // полосы, иначе запись, получившая второй шанс, вытеснялась бы в том же заходе. Запись с признаком
+    // обращения уходит в конец очереди; только что вставленная запись не вытесняется.
+    static Advance advance(Items & items, Shelf & shelf, const Key & placed, const size_t limit) {
+        Advance result {};
+        auto & queue = queueOf(shelf, Priority::Regular);
+        const auto steps = std::min(c_cacheClockSteps, queue.size());
+        while (result.m_examined < steps && s_bytes.load(std::memory_order_relaxed) > limit) {
+            ++result.m_examined;
+            const auto it = items.find(*queue.front());
+            if (it->second.m_referenced.exchange(false, std::memory_order_relaxed) || it->first == placed) {
+                queue.splice(queue.end(), queue, queue.begin());
+                continue;
+            }
+            remove(items, shelf, it);
+            ++result.m_evicted;
+        }
+        return result;
+    }
+
+    // Вытесняет обычные записи, пока кэш в целом превышает бюджет. Долговременные записи не вытесняются:
+    // они удаляются только по истечении срока хранения. Стрелка делает не больше двух кругов по обычным
+    // записям (первый снимает признаки обращения, второй вытесняет), поэтому записи, которые читаются
+    // постоянно, не зацикливают вытеснение.
+    static size_t evict(const Key & placed, const size_t limit) {
+        const auto bound = 2 * s_regular.load(std::memory_order_relaxed);
+        size_t examined { 0 }, evicted { 0 }, idle { 0 };
+        while (s_bytes.load(std::memory_order_relaxed) > limit && examined < bound && idle < s_cache.stripes()) {
+            const auto step = s_cache.exclusiveAt(
+                s_hand.fetch_add(1, std::memory_order_relaxed),
+                [&placed, limit] (Items & items, Shelf & shelf) { return advance(items, shelf, placed, limit); }
+            );
+            examined += step.m_examined;
+            evicted += step.m_evicted;
+            idle = step.m_examined ? 0 : idle + 1;
+        }
+        return evicted;
+    }
+
+    static void place(const Key & key, Entry && entry) {
+        const auto bytes
+            = key.size() + entry.m_tag.size() + c_cacheEntryOverhead + (entry.m_data ? entry.m_data->memoryUsage() : 0);
+        const auto limit = budget();
+        if (bytes > limit) {
+            LOG_DEBUG_TS(Wcs::c_cacheTooLarge, bytes);
+            return;
+        }
+
+        s_cache.exclusive(
+            key,
+            [&key, &entry, bytes] (Items & items, Shelf & shelf) {
+                if (const auto it = items.find(key); it != items.end()) {
+                    remove(items, shelf, it);
+                }
+
+                const auto expiredAt = entry.m_expiredAt;
+                const auto priority = entry.m_priority;
+                const auto it = items.try_emplace(key, std::move(entry), bytes).first;
+                auto & queue = queueOf(shelf, priority);
+                it->second.m_position = queue.insert(queue.end(), &it->first);
+                s_bytes.fetch_add(bytes, std::memory_order_relaxed);
+                if (priority == Priority::Regular) {
+                    s_regular.fetch_add(1, std::memory_order_relaxed);
+                }
+                shelf.m_deadlines.push({ expiredAt, key });
+
+                // Частая замена одних и тех же ключей копит устаревшие сроки: перестраиваем очередь.
+                if (shelf.m_deadlines.size() > c_cacheDeadlinesSlack + items.size() * 2) {
+                    std::vector<Deadline> actual {};
+                    actual.reserve(items.size());
+                    for (const auto & [itemKey, slot] : items) {
+                        actual.push_back({ slot.m_entry.m_expiredAt, itemKey });
+                    }
+                    shelf.m_deadlines = Deadlines { Later {}, std::move(actual) };
+                }
+            }
+        );
+
+        const auto evicted = s_bytes.load(std::memory_order_relaxed) > limit ? evict(key, limit) : 0;
+        if (evicted) {
+            LOG_DEBUG_TS(Wcs::c_cacheEvicted, evicted);
+        }
+
+        // Остались одни долговременные записи: бюджет превышается, но ответы на фискальные команды сохраняются.
+        const auto used = s_bytes.load(std::memory_order_relaxed);
+        if (used <= limit) {
+            s_overdrawn.store(false, std::memory_order_relaxed);
+        } else if (!s_overdrawn.exchange(true, std::memory_order_relaxed)) {
+            LOG_WARNING_TS(Wcs::c_cacheOverdrawn, used - limit);
+        }
+    }
 
     [[maybe_unused]]
-    void store(const Key & key, Entry & entry) {
-        std::scoped_lock cacheLock(s_cacheMutex);
-        entry.m_cachedAt = DateTime::Clock::now();
-        s_cache[key] = entry;
+    void store(const Key & key, const Entry & entry) {
+        auto copy = entry;
+        copy.m_cachedAt = DateTime::Clock::now();
+        place(key, std::move(copy));
     }
 
     [[maybe_unused]]
     void store(const Key & key, Entry && entry) {
-        std::scoped_lock cacheLock(s_cacheMutex);
         entry.m_cachedAt = DateTime::Clock::now();
-        s_cache[key] = std::forward<Entry>(entry);
+        place(key, std::move(entry));
     }
 
     [[maybe_unused]]
-    void store(
+    std::shared_ptr<Http::SerializedResponse> store(
         const Key & key,
         const DateTime::Point expiredAt,
         const Http::Status status,
-        std::shared_ptr<Http::ProtoResponse> data
+        Http::ProtoResponse & response,
+        const Priority priority
     ) {
-        std::scoped_lock cacheLock(s_cacheMutex);
-        s_cache[key] = {
-            .m_data = std::move(data),
-            .m_cachedAt = DateTime::Clock::now(),
-            .m_expiredAt = expiredAt,
-            .m_status = status
-        };
+        // Сериализуем и сжимаем вне блокировки: попадание в кэш потом сводится к записи готовых байтов.
+        auto data = Http::SerializedResponse::from(response, status, static_cast<size_t>(s_compressionThreshold));
+        place(
+            key,
+            Entry {
+                .m_data = data,
+                .m_cachedAt = DateTime::Clock::now(),
+                .m_expiredAt = expiredAt,
+                .m_status = status,
+                .m_priority = priority
+            }
+        );
+        return data;
     }
 
     [[nodiscard, maybe_unused]]
     std::optional<Entry> load(const Key & key) {
-        std::scoped_lock cacheLock(s_cacheMutex);
-        const auto it = s_cache.find(key);
-        if (it == s_cache.end()) {
-            return std::nullopt;
-        }
-        return it->second;
+        std::optional<Entry> result {};
+        s_cache.visit(
+            key,
+            [&result] (const Slot & slot) {
+                slot.m_referenced.store(true, std::memory_order_relaxed);
+                result = slot.m_entry;
+            }
+        );
+        return result;
     }
 
+    // Просматриваются только истёкшие сроки из начала очередей, поэтому стоимость пропорциональна
+    // числу удаляемых записей, а не размеру кэша.
     [[maybe_unused]]
-    void maintain() {
-        if (++s_counter >= c_cacheCleanUpThreshold) {
-            std::scoped_lock cacheLock(s_cacheMutex);
-            const auto oldSize = s_cache.size();
-            std::erase_if(
-                s_cache,
-                [] (const auto & item) { return item.second.m_expiredAt < DateTime::Clock::now(); }
-            );
-            LOG_DEBUG_TS(Wcs::c_cacheMaintain, oldSize, s_cache.size());
-            s_counter = 0;
+    size_t expire() {
+        const auto now = DateTime::Clock::now();
+        const auto expired = s_cache.sweep(
+            [now] (Items & items, Shelf & shelf) {
+                auto & deadlines = shelf.m_deadlines;
+                size_t erased { 0 };
+                while (!deadlines.empty() && deadlines.top().m_at < now) {
+                    const auto & deadline = deadlines.top();
+                    if (const auto it = items.find(deadline.m_key);
+                        it != items.end() && it->second.m_entry.m_expiredAt == deadline.m_at) {
+                        remove(items, shelf, it);
+                        ++erased;
+                    }
+                    deadlines.pop();
+                }
+                return erased;
+            }
+        );
+        if (expired) {
+            LOG_DEBUG_TS(Wcs::c_cacheMaintain, expired, s_cache.size());
         }
+        return expired;
     }
 }
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "server_cache_types.h"
+#include <cstddef>
 #include <optional>
 
 namespace Server::Cache {
@@ -14,7 +15,11 @@ namespace Server::Cache {
 
     [[maybe_unused]] void store(const Key &, const Entry &);
     [[maybe_unused]] void store(const Key &, Entry &&);
-    [[maybe_unused]] void store(const Key &, DateTime::Point, Http::Status, std::shared_ptr<Http::ProtoResponse>);
+    [[maybe_unused]]
+    std::shared_ptr<Http::SerializedResponse> store(
+        const Key &, DateTime::Point, Http::Status, Http::ProtoResponse &, Priority = Priority::Regular
+    );
     [[nodiscard, maybe_unused]] std::optional<Entry> load(const Key &);
-    [[maybe_unused]] void maintain();
+    // Удаляет записи с истёкшим сроком хранения; вызывается периодически вне обработки запросов.
+    [[maybe_unused]] size_t expire();
 }
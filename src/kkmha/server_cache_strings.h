@@ -9,4 +9,11 @@ namespace Server::Cache::Wcs {
     using Csv = const std::wstring_view;
 
     constexpr Csv c_fromCache { L"Запрос [{:04x}]: Данные взяты из кеша" };
+    constexpr Csv c_cacheMaintain { L"Обслуживание кэша (удалено {}, осталось {})" };
+    constexpr Csv c_cacheTooLarge { L"Ответ не помещается в кэш ({} байт)" };
+    constexpr Csv c_cacheEvicted { L"Кэш переполнен, вытеснено записей: {}" };
+    constexpr Csv c_cacheOverdrawn {
+        L"Ответы на фискальные команды превысили лимит кэша на {} байт и хранятся до истечения срока. "
+        L"Увеличьте server.cacheMemoryLimit"
+    };
 }
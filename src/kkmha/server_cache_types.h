@@ -4,17 +4,27 @@
 #pragma once
 
 #include "http_types.h"
-#include "http_proto_response.h"
+#include "http_serialized_response.h"
 #include <lib/datetime.h>
+#include <cstdint>
 #include <memory>
+#include <string>
 
 namespace Server::Cache {
     using Key = std::string;
 
+    // При нехватке памяти вытесняются только обычные записи, долговременные хранятся до истечения срока,
+    // даже если бюджет превышен. Долговременными помечаются ответы на фискальные команды с ключом
+    // идемпотентности: их потеря приведёт к повторному выполнению операции на ККМ.
+    enum class Priority { Regular, Durable };
+
     struct Entry {
-        std::shared_ptr<Http::ProtoResponse> m_data;
+        std::shared_ptr<Http::SerializedResponse> m_data;
         DateTime::Point m_cachedAt;
         DateTime::Point m_expiredAt;
         Http::Status m_status;
+        Priority m_priority { Priority::Regular };
+        std::string m_tag {}; // Валидатор (ETag) несжатого варианта для условных запросов
+        uint64_t m_generation { 0 }; // Поколение источника, из которого получены данные
     };
 }
@@ -7,20 +7,40 @@
 #include "server_failure.h"
 #include "server_counter.h"
 #include "server_hitman.h"
+#include "server_admission.h"
+#include "server_arena.h"
+#include "server_worker_pool.h"
 #include "server_default_handler.h"
 #include "server_kkmop_handler.h"
+#include "server_kkmop_pool.h"
+#include "server_cache_core.h"
+#include "server_journal.h"
+#include "server_tls_session.h"
+#include "server_http2.h"
 #include "server_static_handler.h"
+#include "server_static_watcher.h"
 #include "server_config_handler.h"
 #include "server_ping_handler.h"
+#include "server_metrics_handler.h"
+#include "server_metrics.h"
 #include "http_parser.h"
 #include "http_request.h"
+#include "http_constant_response.h"
+#include "http_wire.h"
+#include "http_gzip.h"
+#include <lib/defer.h>
+#include <lib/hash.h>
 #include <cassert>
 #include <utility>
 #include <memory>
+#include <memory_resource>
+#include <exception>
+#include <array>
 #include <atomic>
 #include <latch>
 #include <thread>
 #include <chrono>
+#include <vector>
 
 namespace Server {
     using namespace std::chrono_literals;
@@ -31,15 +51,30 @@ namespace Server {
 
     static std::atomic s_state { State::Initial };
     static Counter::Type s_concurrentRequestsCounter { 0 };
-    static Counter::Type s_delayedSocketsCounter { 0 };
+    static Counter::Type s_rejectedSocketsCounter { 0 };
     static Hitman s_hitman {};
+    static Admission s_admission {};
+    static WorkerPool s_workerPool {};
+    static std::atomic_flag s_housekeepingBusy {};
     static std::latch s_shutdownSync { 2 };
 
+    // Реактор - отдельный io_context со своим потоком. Акцептор живёт в первом реакторе и раздаёт
+    // принятые соединения всем реакторам по кругу, соединение до закрытия обслуживается одним реактором.
+    struct Reactor {
+        Asio::IoContext m_context { 1 };
+        asio::executor_work_guard<Asio::IoContext::executor_type> m_guard { m_context.get_executor() };
+        Counter::Type m_active { 0 };
+        std::atomic<uint64_t> m_accepted { 0 };
+    };
+
+    static std::vector<std::unique_ptr<Reactor>> s_reactors {};
+
     static Default::Handler s_defaultHandler {};
     static KkmOp::Handler s_kkmHandler {};
     static Static::Handler s_staticHandler {};
     static Config::Handler s_configHandler {};
     static Ping::Handler s_pingHandler {};
+    static Metrics::Handler s_metricsHandler {};
 
     /*inline*/ void logError() noexcept {
         switch (s_state.load()) {
@@ -55,106 +90,276 @@ namespace Server {
         }
     }
 
+    // Порядок совпадает с s_areaHandlers.
+    constexpr Hash::Perfect<5> c_areas {
+        std::array<std::string_view, 5> { "kkm", "static", "config", "ping", "metrics" }
+    };
+
+    static const std::array<ProtoHandler *, c_areas.size()> s_areaHandlers {
+        &s_kkmHandler, &s_staticHandler, &s_configHandler, &s_pingHandler, &s_metricsHandler
+    };
+
     [[nodiscard]]
     /*inline*/ ProtoHandler & lookupHandler(const Http::Request & request) {
-        // ISSUE: При большем количестве обработчиков стоит оптимизировать.
         if (request.m_hint.size() >= 2) {
-            const auto area = request.m_hint[1];
-            if (area == "kkm") {
-                return s_kkmHandler;
-            }
-            if (area == "static") {
-                return s_staticHandler;
-            }
-            if (area == "config") {
-                return s_configHandler;
-            }
-            if (area == "ping") {
-                return s_pingHandler;
+            if (const auto index = c_areas.find(request.m_hint[1]); index != c_areas.c_npos) {
+                return *s_areaHandlers[index];
             }
         }
         return s_defaultHandler;
     }
 
+    [[nodiscard]]
+    /*inline*/ std::string routeOf(const Http::Request & request) {
+        const auto & hint = request.m_hint;
+        if (hint.size() < 2) {
+            return "default";
+        }
+        const auto & area = hint[1];
+        if (area == "kkm" && hint.size() >= 3 && request.m_response.m_status != Http::Status::NotFound) {
+            return Text::concat(hint[0], "/kkm/", hint.back());
+        }
+        if (c_areas.find(area) != c_areas.c_npos) {
+            return Text::concat(hint[0], "/", area);
+        }
+        return "default";
+    }
+
     template<typename CompletionToken>
-    auto performAsync(const ProtoHandler & handler, Http::Request & request, CompletionToken && token) {
+    auto performAsync(
+        Asio::Executor executor,
+        const ProtoHandler & handler,
+        Http::Request & request,
+        CompletionToken && token
+    ) {
         return
-            asio::async_compose<CompletionToken, void()>(
-                [& handler, & request] (auto && self) {
-                    std::thread(
-                        [task = std::move(self), & handler, & request] () mutable { // NOLINT(*-move-forwarding-reference)
-                            handler(request);
-                            task.complete();
-                        }
-                    ).detach();
+            asio::async_compose<CompletionToken, void(std::exception_ptr)>(
+                [executor = std::move(executor), & handler, & request] (auto && self) {
+                    // Корутина возобновляется ровно один раз: либо по завершении обработчика, либо с ошибкой
+                    // (в том числе если задача снята с очереди при остановке пула).
+                    // Исполнитель копируем до перемещения self: эта лямбда хранится внутри него.
+                    using Self = std::remove_cvref_t<decltype(self)>;
+                    Asio::Executor target { executor };
+                    auto task = std::make_shared<Self>(std::move(self)); // NOLINT(*-move-forwarding-reference)
+                    auto resume =
+                        [target = std::move(target), task = std::move(task)] (std::exception_ptr error) {
+                            // Возобновляем корутину в потоке io_context, а не в потоке пула.
+                            asio::post(
+                                target,
+                                [task, error = std::move(error)] () mutable { task->complete(std::move(error)); }
+                            );
+                        };
+                    s_workerPool.submit(
+                        [resume, & handler, & request] (const WorkerPool::Duration waited) {
+                            LOG_DEBUG_TS(
+                                [& request, waited] {
+                                    const auto stats = s_workerPool.stats();
+                                    return std::format(
+                                        Wcs::c_workerPoolQueued, request.m_id, waited.count(),
+                                        stats.m_queueDepth, stats.m_busy, stats.m_threads
+                                    );
+                                }
+                            );
+                            // Обработчик может отложить завершение, освободив поток пула до готовности ответа.
+                            handler(request, [resume] { resume(nullptr); });
+                        },
+                        resume
+                    );
                 },
                 std::forward<CompletionToken>(token)
             );
     }
 
-    asio::awaitable<void> accept(Asio::TcpSocket && socket, Asio::SslContext & sslContext) {
-        Counter counter { s_concurrentRequestsCounter };
+    asio::awaitable<void> process(Http::Request & request, Metrics::Timing & timing) {
+        if (request.m_response.m_status == Http::Status::Ok) {
+            LOG_INFO_TS(
+                [& request] {
+                    std::string message {
+                        std::format(
+                            Mbs::c_requestedMethod,
+                            request.m_remote.to_string(),
+                            request.m_verb,
+                            request.m_path
+                        )
+                    };
+                    return std::format(Mbs::c_prefixedText, request.m_id, message);
+                }
+            );
+        }
 
+        if (
+            request.m_response.m_status < Http::Status::BadRequest
+            && (!s_loopbackWithoutSecret || !Asio::isLoopback(request.m_remote))
+        ) {
+            const auto secret = request.m_header[Http::Field::XSecret];
+            if (secret.empty() || secret != s_secret) {
+                request.m_response.m_status = Http::Status::Forbidden;
+                request.m_response.m_data.emplace<1>(Mbs::c_forbidden);
+                LOG_ERROR_TS(Wcs::c_forbidden, request.m_id);
+            }
+        }
+        timing.lap(Metrics::Phase::Authorize);
+
+        if (request.m_response.m_status == Http::Status::Ok) {
+            ProtoHandler & handler = lookupHandler(request);
+            if (handler.asyncReady()) {
+                co_await performAsync(co_await asio::this_coro::executor, handler, request, asio::use_awaitable);
+            } else {
+                (handler)(request);
+            }
+            timing.lap(Metrics::Phase::Handle);
+        }
+    }
+
+    void render(Http::Request & request, Http::Wire & wire, const bool keepAlive) {
+        if (s_compressionThreshold > 0) {
+            wire.negotiateGzip(
+                static_cast<size_t>(s_compressionThreshold),
+                Http::Gzip::accepted(request.m_header[Http::Field::AcceptEncoding])
+            );
+        }
+        request.m_response.render(wire, keepAlive);
+    }
+
+    void record(const Http::Request & request, Metrics::Timing & timing) {
+        timing.finish();
+        Metrics::record(routeOf(request), timing);
+    }
+
+    [[maybe_unused]]
+    constexpr Http2::Exchange c_exchange {
+        process, render, record, [] () noexcept { return s_state.load() == State::Running; }
+    };
+
+    // admitted - занят ли соединением слот допуска. Пока постоянное соединение ждёт следующего запроса,
+    // слот отдаётся другим соединениям, и запрос, пришедший после простоя, снова проходит допуск.
+    asio::awaitable<void> accept(Asio::TcpSocket && socket, Asio::SslContext & sslContext, bool & admitted) {
         try {
             Asio::Stream stream { std::forward<Asio::TcpSocket>(socket), sslContext };
-            Http::Request request { stream.lowest_layer().remote_endpoint().address() };
-            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(s_requestTimeout);
+            const Asio::IpAddress remote { stream.lowest_layer().remote_endpoint().address() };
             Asio::Timer timeoutTimer { co_await asio::this_coro::executor };
             Asio::Error error {};
             Asio::CancellationSignal signal {};
+            Http::Request::IdType lastId {};
+            uint64_t timerGeneration { 0 };
+            int64_t served { 0 };
             bool canceled { false };
+            bool keepAlive { false };
+#if WITH_HTTP2
+            bool http2 { false };
+#endif
 
-            LOG_DEBUG_TS(
-                [& request] {
-                    std::string message { std::format(Mbs::c_connectionWith, request.m_remote.to_string()) };
-                    return std::format(Mbs::c_prefixedText, request.m_id, message);
-                }
-            );
-
-            timeoutTimer.expires_at(deadline);
-            timeoutTimer.async_wait(
-                [& signal, & canceled]
-                (Asio::Error error) {
-                    if (!error) {
-                        canceled = true;
-                        signal.emit(asio::cancellation_type::all);
+            // Таймер перезаводится перед каждым запросом соединения. Поколение отсекает срабатывание,
+            // которое уже было поставлено в очередь до перезавода.
+            auto armTimer = [& timeoutTimer, & signal, & canceled, & timerGeneration] (const auto deadline) {
+                timeoutTimer.expires_at(deadline);
+                timeoutTimer.async_wait(
+                    [& signal, & canceled, & timerGeneration, generation = ++timerGeneration]
+                    (Asio::Error error) {
+                        if (!error && generation == timerGeneration) {
+                            canceled = true;
+                            signal.emit(asio::cancellation_type::all);
+                        }
                     }
-                }
-            );
+                );
+            };
 
-            try {
-                {
-                    co_await stream.async_handshake(
-                        asio::ssl::stream_base::server,
-                        asio::bind_cancellation_slot(
-                            signal.slot(),
-                            asio::redirect_error(asio::use_awaitable, error)
-                        )
-                    );
-                    if (error) {
-                        throw Failure(request.m_id, Mbs::c_sslHandshakeOperation, error); // NOLINT(*-exception-baseclass)
-                    }
-                }
+            // Контейнеры разбора запроса размещаются в арене соединения (что в неё не попадает - см. server_arena.h).
+            // Арена сбрасывается перед каждым запросом и освобождается целиком при закрытии соединения.
+            std::array<std::byte, c_connectionArenaSize> arenaStorage; // NOLINT(*-member-init)
+            std::pmr::monotonic_buffer_resource arena { arenaStorage.data(), arenaStorage.size(), &Arena::s_upstream };
 
-                if (!canceled) {
-                    Asio::StreamBuffer buffer {};
+            // Буфер приёма живёт всё соединение: байты следующих запросов, полученные вместе с текущим,
+            // сохраняются и разбираются на следующих итерациях (конвейерная обработка HTTP/1.1). Разобранный
+            // запрос ссылается на содержимое буфера, поэтому байты запроса удаляются из него только после ответа.
+            Asio::StreamBuffer buffer {};
 
-                    co_await asio::async_read_until(
-                        stream, buffer,
-                        "\r\n\r\n",
-                        asio::bind_cancellation_slot(
-                            signal.slot(),
-                            asio::redirect_error(asio::use_awaitable, error)
-                        )
+            do {
+                arena.release();
+                Http::Request request { Asio::IpAddress { remote }, &arena };
+                size_t consumed { 0 };
+                const bool idle { served > 0 };
+                Metrics::Timing timing {};
+                lastId = request.m_id;
+                keepAlive = false;
+
+                if (idle) {
+                    armTimer(std::chrono::steady_clock::now() + std::chrono::seconds(s_keepAliveTimeout));
+                } else {
+                    LOG_DEBUG_TS(
+                        [& request] {
+                            std::string message { std::format(Mbs::c_connectionWith, request.m_remote.to_string()) };
+                            return std::format(Mbs::c_prefixedText, request.m_id, message);
+                        }
                     );
-                    if (error) {
-                        throw Failure(request.m_id, Mbs::c_sslReadOperation, error); // NOLINT(*-exception-baseclass)
+                    armTimer(std::chrono::steady_clock::now() + std::chrono::seconds(s_requestTimeout));
+                }
+
+                try {
+                    if (!idle) {
+                        co_await stream.async_handshake(
+                            asio::ssl::stream_base::server,
+                            asio::bind_cancellation_slot(
+                                signal.slot(),
+                                asio::redirect_error(asio::use_awaitable, error)
+                            )
+                        );
+                        if (error) {
+                            throw Failure(request.m_id, Mbs::c_sslHandshakeOperation, error); // NOLINT(*-exception-baseclass)
+                        }
+                        if (TlsSession::handshaked(stream.native_handle())) {
+                            LOG_DEBUG_TS(Wcs::c_prefixedText, request.m_id, Wcs::c_sessionResumed);
+                        }
+                        timing.lap(Metrics::Phase::Handshake);
+#if WITH_HTTP2
+                        if (Http2::negotiated(stream.native_handle())) {
+                            LOG_DEBUG_TS(Wcs::c_prefixedText, request.m_id, Wcs::c_http2Negotiated);
+                            http2 = true;
+                            break;
+                        }
+#endif
                     }
 
-                    Http::Parser parser(request);
-                    parser(buffer);
+                    if (!canceled) {
+                        if (idle && buffer.size() > 0) {
+                            LOG_DEBUG_TS(Wcs::c_prefixedText, request.m_id, Wcs::c_pipelined);
+                        } else if (idle && admitted) {
+                            s_admission.leave();
+                            admitted = false;
+                        }
 
-                    if (request.m_method == Http::Method::Post) {
+                        co_await asio::async_read_until(
+                            stream, buffer,
+                            "\r\n\r\n",
+                            asio::bind_cancellation_slot(
+                                signal.slot(),
+                                asio::redirect_error(asio::use_awaitable, error)
+                            )
+                        );
+                        if (error) {
+                            if (idle && (canceled || buffer.size() == 0)) {
+                                // Клиент закрыл постоянное соединение или истёк таймаут простоя - это не ошибка.
+                                LOG_DEBUG_TS(Wcs::c_prefixedText, request.m_id, Wcs::c_keepAliveClosed);
+                                canceled = false;
+                                break;
+                            }
+                            throw Failure(request.m_id, Mbs::c_sslReadOperation, error); // NOLINT(*-exception-baseclass)
+                        }
+
+                        if (idle) {
+                            // Время ожидания следующего запроса в постоянном соединении не учитываем.
+                            timing.restart();
+                            armTimer(std::chrono::steady_clock::now() + std::chrono::seconds(s_requestTimeout));
+                        } else {
+                            timing.lap(Metrics::Phase::Read);
+                        }
+
+                        Http::Parser parser(request);
+                        parser(buffer);
+                        timing.lap(Metrics::Phase::Parse);
+
+                        // Тело с Content-Length дочитывается при любом методе: иначе его остаток в постоянном
+                        // соединении был бы разобран как следующий запрос.
                         auto expecting = parser.expecting();
                         while (!canceled && expecting) {
                             co_await asio::async_read(
@@ -168,86 +373,106 @@ namespace Server {
                             if (error) {
                                 throw Failure(request.m_id, Mbs::c_sslReadOperation, error); // NOLINT(*-exception-baseclass)
                             }
+                            timing.lap(Metrics::Phase::Read);
                             parser(buffer);
                             expecting = parser.expecting();
+                            timing.lap(Metrics::Phase::Parse);
                         }
-                    }
-                    parser.complete();
-                }
+                        parser.complete();
+                        consumed = parser.consumed();
+                        timing.lap(Metrics::Phase::Parse);
 
-                if (!canceled) {
-                    if (request.m_response.m_status == Http::Status::Ok) {
-                        LOG_INFO_TS(
-                            [& request] {
-                                std::string message {
-                                    std::format(
-                                        Mbs::c_requestedMethod,
-                                        request.m_remote.to_string(),
-                                        request.m_verb,
-                                        request.m_path
-                                    )
-                                };
-                                return std::format(Mbs::c_prefixedText, request.m_id, message);
+                        // Ожидание в очереди прерывается вместе с запросом: по таймауту запроса или отмене
+                        // соединения оно покидает очередь.
+                        if (!admitted && !canceled) {
+                            const auto verdict
+                                = co_await s_admission.enter(
+                                    s_concurrencyLimit, s_admissionQueueSize, std::chrono::seconds(s_admissionTimeout),
+                                    signal.slot(), timeoutTimer.expiry()
+                                );
+                            admitted = verdict == Admission::Verdict::Admitted;
+                            if (verdict == Admission::Verdict::Canceled) {
+                                canceled = true;
+                            } else if (!admitted) {
+                                LOG_WARNING_TS(
+                                    Wcs::c_prefixedText, request.m_id,
+                                    verdict == Admission::Verdict::Overflow
+                                        ? Wcs::c_maximumIsExceeded : Wcs::c_admissionTimeout
+                                );
+                                request.m_response.m_status = Http::Status::ServiceUnavailable;
                             }
-                        );
+                        }
+                        keepAlive = request.m_keepAlive && request.m_response.m_status == Http::Status::Ok;
                     }
 
-                    if (
-                        request.m_response.m_status < Http::Status::BadRequest
-                        && (!s_loopbackWithoutSecret || !Asio::isLoopback(request.m_remote))
-                    ) {
-                        auto it = request.m_header.find("x-secret");
-                        if (it == request.m_header.end() || it->second.empty() || it->second != s_secret) {
-                            request.m_response.m_status = Http::Status::Forbidden;
-                            request.m_response.m_data.emplace<1>(Mbs::c_forbidden);
-                            LOG_ERROR_TS(Wcs::c_forbidden, request.m_id);
-                        }
+                    if (!canceled) {
+                        co_await process(request, timing);
                     }
 
-                    if (request.m_response.m_status == Http::Status::Ok) {
-                        ProtoHandler & handler = lookupHandler(request);
-                        if (handler.asyncReady()) {
-                            co_await performAsync(handler, request, asio::use_awaitable);
-                        } else {
-                            (handler)(request);
+                    if (!canceled) {
+                        keepAlive
+                            = keepAlive
+                            && s_keepAliveTimeout > 0
+                            && served + 1 < s_keepAliveMaxRequests
+                            && s_state.load() == State::Running
+                            && request.m_response.keepAliveReady();
+
+                        Http::Wire wire {};
+                        render(request, wire, keepAlive);
+                        co_await asio::async_write(
+                            stream, wire.buffers(),
+                            asio::bind_cancellation_slot(
+                                signal.slot(),
+                                asio::redirect_error(asio::use_awaitable, error)
+                            )
+                        );
+                        if (error) {
+                            throw Failure(request.m_id, Mbs::c_sslWriteOperation, error); // NOLINT(*-exception-baseclass)
                         }
+                        timing.lap(Metrics::Phase::Write);
+                        record(request, timing);
                     }
-                }
 
-                if (!canceled) {
-                    Asio::StreamBuffer buffer {};
-                    request.m_response.render(buffer);
-                    co_await asio::async_write(
-                        stream, buffer,
-                        asio::bind_cancellation_slot(
-                            signal.slot(),
-                            asio::redirect_error(asio::use_awaitable, error)
-                        )
-                    );
-                    if (error) {
-                        throw Failure(request.m_id, Mbs::c_sslWriteOperation, error); // NOLINT(*-exception-baseclass)
+                } catch (const Basic::Failure & e) {
+                    keepAlive = false;
+                    if (!canceled) {
+                        request.m_response.m_status = Http::Status::InternalServerError;
+                        LOG_ERROR_TS(e);
+                    }
+                } catch (const std::exception & e) {
+                    keepAlive = false;
+                    if (!canceled) {
+                        request.m_response.m_status = Http::Status::InternalServerError;
+                        LOG_ERROR_TS(e);
+                    }
+                } catch (...) {
+                    keepAlive = false;
+                    if (!canceled) {
+                        request.m_response.m_status = Http::Status::InternalServerError;
+                        LOG_ERROR_TS(Basic::Wcs::c_somethingWrong);
                     }
                 }
 
-            } catch (const Basic::Failure & e) {
-                if (!canceled) {
-                    request.m_response.m_status = Http::Status::InternalServerError;
-                    LOG_ERROR_TS(e);
-                }
-            } catch (const std::exception & e) {
-                if (!canceled) {
-                    request.m_response.m_status = Http::Status::InternalServerError;
-                    LOG_ERROR_TS(e);
-                }
-            } catch (...) {
-                if (!canceled) {
-                    request.m_response.m_status = Http::Status::InternalServerError;
-                    LOG_ERROR_TS(Basic::Wcs::c_somethingWrong);
+                ++served;
+                buffer.consume(consumed);
+
+                if (canceled) {
+                    LOG_WARNING_TS(Wcs::c_prefixedText, request.m_id, Wcs::c_timeoutExpired);
+                } else if (request.m_response.m_status < Http::Status::BadRequest) {
+                    LOG_INFO_TS(Wcs::c_prefixedText, request.m_id, Wcs::c_processingSuccess);
+                } else {
+                    LOG_WARNING_TS(Wcs::c_prefixedText, request.m_id, Wcs::c_processingFailed);
                 }
-            }
+            } while (keepAlive && !canceled);
 
             timeoutTimer.cancel();
 
+#if WITH_HTTP2
+            if (http2) {
+                co_await Http2::serve(stream, remote, c_exchange);
+            }
+#endif
+
             {
                 stream.lowest_layer().cancel();
 
@@ -271,12 +496,12 @@ namespace Server {
                         ) {
                             if (Log::s_appendLocation) {
                                 LOG_ERROR_TS(
-                                    Mbs::c_prefixedOperationWithSource, request.m_id, Mbs::c_sslShutdownOperation,
+                                    Mbs::c_prefixedOperationWithSource, lastId, Mbs::c_sslShutdownOperation,
                                     error.message(), SrcLoc::toMbs(SrcLoc::Point::current())
                                 );
                             } else {
                                 LOG_ERROR_TS(
-                                    Mbs::c_prefixedOperation, request.m_id, Mbs::c_sslShutdownOperation, error.message()
+                                    Mbs::c_prefixedOperation, lastId, Mbs::c_sslShutdownOperation, error.message()
                                 );
                             }
                         }
@@ -289,26 +514,138 @@ namespace Server {
                     if (error) {
                         if (Log::s_appendLocation) {
                             LOG_ERROR_TS(
-                                Mbs::c_prefixedOperationWithSource, request.m_id, Mbs::c_socketCloseOperation,
+                                Mbs::c_prefixedOperationWithSource, lastId, Mbs::c_socketCloseOperation,
                                 error.message(), SrcLoc::toMbs(SrcLoc::Point::current())
                             );
                         } else {
                             LOG_ERROR_TS(
-                                Mbs::c_prefixedOperation, request.m_id, Mbs::c_socketCloseOperation, error.message()
+                                Mbs::c_prefixedOperation, lastId, Mbs::c_socketCloseOperation, error.message()
                             );
                         }
                     }
                 }
             }
 
-            if (canceled) {
-                LOG_WARNING_TS(Wcs::c_prefixedText, request.m_id, Wcs::c_timeoutExpired);
-            } else if (request.m_response.m_status < Http::Status::BadRequest) {
-                LOG_INFO_TS(Wcs::c_prefixedText, request.m_id, Wcs::c_processingSuccess);
+        } catch (const Basic::Failure & e) {
+            LOG_ERROR_TS(e);
+        } catch (const std::exception & e) {
+            LOG_ERROR_TS(e);
+        } catch (...) {
+            LOG_ERROR_TS(Basic::Wcs::c_somethingWrong);
+        }
+
+        co_return;
+    }
+
+    asio::awaitable<void> reject(Asio::TcpSocket && socket, Asio::SslContext & sslContext) noexcept {
+        Counter counter { s_rejectedSocketsCounter };
+
+        try {
+            // Отказ тоже требует TLS-рукопожатия, иначе клиент увидит лишь оборванное соединение.
+            // Всё обслуживание отказа ограничено коротким таймаутом.
+            Asio::Stream stream { std::forward<Asio::TcpSocket>(socket), sslContext };
+            Asio::Timer timeoutTimer { co_await asio::this_coro::executor };
+            Asio::Error error {};
+
+            timeoutTimer.expires_after(c_rejectTimeout);
+            timeoutTimer.async_wait(
+                [& stream] (Asio::Error error) {
+                    if (!error) {
+                        stream.lowest_layer().cancel(error); // NOLINT(*-unused-return-value)
+                    }
+                }
+            );
+
+            co_await stream.async_handshake(
+                asio::ssl::stream_base::server,
+                asio::redirect_error(asio::use_awaitable, error)
+            );
+
+            if (!error) {
+                Asio::StreamBuffer buffer { c_rejectBufferSize };
+                co_await asio::async_read_until(
+                    stream, buffer,
+                    "\r\n\r\n",
+                    asio::redirect_error(asio::use_awaitable, error)
+                );
+            }
+
+            if (!error) {
+                Http::Wire wire {};
+                Http::ConstantResponse::s_serviceUnavailableResponse->render(
+                    wire, Http::Status::ServiceUnavailable, false
+                );
+                co_await asio::async_write(stream, wire.buffers(), asio::redirect_error(asio::use_awaitable, error));
+            }
+
+            if (!error) {
+                co_await stream.async_shutdown(asio::redirect_error(asio::use_awaitable, error));
+            }
+
+            timeoutTimer.cancel();
+            stream.lowest_layer().close(error); // NOLINT(*-unused-return-value)
+        } catch (...) {}
+
+        co_return;
+    }
+
+    asio::awaitable<void> serve(Asio::TcpSocket socket, Asio::SslContext & sslContext, Reactor & reactor) noexcept {
+        Counter counter { s_concurrentRequestsCounter };
+        Counter reactorCounter { reactor.m_active };
+
+        try {
+            const auto verdict
+                = co_await s_admission.enter(
+                    s_concurrencyLimit, s_admissionQueueSize, std::chrono::seconds(s_admissionTimeout)
+                );
+
+            if (verdict == Admission::Verdict::Admitted) {
+                bool admitted { true };
+                Deferred::Exec admissionLeaver {
+                    [& admitted] {
+                        if (admitted) {
+                            s_admission.leave();
+                        }
+                    }
+                };
+                co_await accept(std::move(socket), sslContext, admitted);
             } else {
-                LOG_WARNING_TS(Wcs::c_prefixedText, request.m_id, Wcs::c_processingFailed);
+                if (verdict == Admission::Verdict::Overflow) {
+                    LOG_ERROR_TS(Wcs::c_maximumIsExceeded);
+                } else {
+                    LOG_WARNING_TS(Wcs::c_admissionTimeout);
+                }
+                if (s_rejectedSocketsCounter >= c_rejectedSockets) {
+                    Asio::Error error {};
+                    socket.shutdown(Asio::TcpSocket::shutdown_both, error); // NOLINT(*-unused-return-value)
+                    socket.close(error); // NOLINT(*-unused-return-value)
+                } else {
+                    co_await reject(std::move(socket), sslContext);
+                }
             }
+        } catch (const Basic::Failure & e) {
+            LOG_ERROR_TS(e);
+        } catch (const std::exception & e) {
+            LOG_ERROR_TS(e);
+        } catch (...) {
+            LOG_ERROR_TS(Basic::Wcs::c_somethingWrong);
+        }
 
+        co_return;
+    }
+
+    asio::awaitable<void> rotateTicketKeys() noexcept {
+        try {
+            Asio::Timer timer { co_await asio::this_coro::executor };
+
+            for (;;) {
+                timer.expires_after(std::chrono::seconds(s_ticketKeyRotation));
+                auto [error] = co_await timer.async_wait(asio::as_tuple(asio::use_awaitable));
+                if (error || s_state.load() != State::Running) {
+                    break;
+                }
+                TlsSession::rotate();
+            }
         } catch (const Basic::Failure & e) {
             LOG_ERROR_TS(e);
         } catch (const std::exception & e) {
@@ -320,18 +657,47 @@ namespace Server {
         co_return;
     }
 
-    asio::awaitable<void> close(Asio::TcpSocket && socket0) {
+    // Удаление устаревших записей кэша и простаивающих соединений с ККМ, перестроение журнала.
+    // Работа выполняется в пуле потоков, чтобы не задерживать ни запросы, ни приём соединений;
+    // пока предыдущий проход не завершён, новый не начинается.
+    asio::awaitable<void> housekeeping() noexcept {
         try {
-            Counter counter { s_delayedSocketsCounter };
-            Asio::TcpSocket socket { std::forward<Asio::TcpSocket>(socket0) }; // Чтобы сокет пережил co_await
             Asio::Timer timer { co_await asio::this_coro::executor };
 
-            timer.expires_after(c_closingDelay);
-            co_await timer.async_wait(asio::use_awaitable);
-            socket.cancel();
-            socket.shutdown(Asio::TcpSocket::shutdown_both);
-            socket.close();
-        } catch (...) {}
+            for (;;) {
+                timer.expires_after(c_housekeepingInterval);
+                auto [error] = co_await timer.async_wait(asio::as_tuple(asio::use_awaitable));
+                if (error || s_state.load() != State::Running) {
+                    break;
+                }
+                if (s_housekeepingBusy.test_and_set()) {
+                    continue;
+                }
+                s_workerPool.submit(
+                    [] (WorkerPool::Duration) {
+                        Deferred::Exec release { [] { s_housekeepingBusy.clear(); } };
+                        try {
+                            Cache::expire();
+                            KkmOp::Pool::maintain();
+                            Journal::compact();
+                        } catch (const Basic::Failure & e) {
+                            LOG_ERROR_TS(e);
+                        } catch (const std::exception & e) {
+                            LOG_ERROR_TS(e);
+                        } catch (...) {
+                            LOG_ERROR_TS(Basic::Wcs::c_somethingWrong);
+                        }
+                    }
+                );
+            }
+        } catch (const Basic::Failure & e) {
+            LOG_ERROR_TS(e);
+        } catch (const std::exception & e) {
+            LOG_ERROR_TS(e);
+        } catch (...) {
+            LOG_ERROR_TS(Basic::Wcs::c_somethingWrong);
+        }
+
         co_return;
     }
 
@@ -370,33 +736,38 @@ namespace Server {
             sslContext.use_certificate_chain_file(Text::convert(s_certificateChainFile.native()));
             sslContext.use_private_key_file(Text::convert(s_privateKeyFile.native()), Asio::SslContext::pem);
             sslContext.set_verify_mode(asio::ssl::verify_none);
+            TlsSession::configure(sslContext);
+            Http2::configure(sslContext);
 
             {
                 auto executor = co_await asio::this_coro::executor;
+                if (s_sessionTickets) {
+                    asio::co_spawn(executor, rotateTicketKeys(), asio::detached);
+                }
+                asio::co_spawn(executor, housekeeping(), asio::detached);
                 Asio::Acceptor acceptor { executor, endpoint };
+                size_t nextReactor { 0 };
 
                 LOG_INFO_TS(Wcs::c_started);
                 s_state.store(State::Running);
 
                 do {
-                    auto [error, socket] = co_await acceptor.async_accept();
+                    const size_t reactorIndex { nextReactor++ % s_reactors.size() };
+                    Reactor & reactor = *s_reactors[reactorIndex];
+                    Asio::TcpSocket socket { reactor.m_context };
+                    auto [error] = co_await acceptor.async_accept(socket);
                     if (error) {
                         LOG_ERROR_TS(Mbs::c_connectionAcceptStatus, error.message());
                         LOG_ERROR_TS(Wcs::c_servicingFailed);
                     } else if (!socket.is_open()) {
                         LOG_ERROR_TS(Wcs::c_socketOpeningError);
                         LOG_ERROR_TS(Wcs::c_servicingFailed);
-                    } else if (s_concurrentRequestsCounter >= s_concurrencyLimit) {
-                        if (s_delayedSocketsCounter >= c_delayedSockets) {
-                            socket.cancel();
-                            socket.shutdown(Asio::TcpSocket::shutdown_both);
-                            socket.close();
-                        } else {
-                            LOG_ERROR_TS(Wcs::c_maximumIsExceeded);
-                            asio::co_spawn(executor, close(std::move(socket)), asio::detached);
-                        }
                     } else {
-                        asio::co_spawn(executor, accept(std::move(socket), sslContext), asio::detached);
+                        ++reactor.m_accepted;
+                        LOG_DEBUG_TS(Wcs::c_reactorAssigned, reactorIndex, reactor.m_active.load());
+                        asio::co_spawn(
+                            reactor.m_context, serve(std::move(socket), sslContext, reactor), asio::detached
+                        );
                     }
                 } while (s_state.load() == State::Running);
 
@@ -447,6 +818,103 @@ namespace Server {
         co_return;
     }
 
+    void Metrics::collect(std::string & output) {
+        appendHelp(output, "kkmha_connections_active", "gauge", "Connections being served or waiting for admission.");
+        appendSample(output, "kkmha_connections_active", {}, static_cast<double>(s_concurrentRequestsCounter.load()));
+        appendHelp(output, "kkmha_connections_rejecting", "gauge", "Connections being answered with 503.");
+        appendSample(output, "kkmha_connections_rejecting", {}, static_cast<double>(s_rejectedSocketsCounter.load()));
+
+        {
+            const auto stats = s_admission.stats();
+            appendHelp(output, "kkmha_admission_queue_depth", "gauge", "Connections waiting in the admission queue.");
+            appendSample(output, "kkmha_admission_queue_depth", {}, static_cast<double>(stats.m_queueDepth));
+            appendHelp(output, "kkmha_admission_total", "counter", "Admission decisions by outcome.");
+            appendSample(
+                output, "kkmha_admission_total", "outcome=\"admitted\"",
+                static_cast<double>(stats.m_admitted)
+            );
+            appendSample(output, "kkmha_admission_total", "outcome=\"queued\"", static_cast<double>(stats.m_queued));
+            appendSample(
+                output, "kkmha_admission_total", "outcome=\"overflow\"",
+                static_cast<double>(stats.m_overflows)
+            );
+            appendSample(output, "kkmha_admission_total", "outcome=\"timeout\"", static_cast<double>(stats.m_timeouts));
+            appendSample(
+                output, "kkmha_admission_total", "outcome=\"canceled\"",
+                static_cast<double>(stats.m_cancellations)
+            );
+        }
+
+        {
+            const auto stats = Arena::s_upstream.stats();
+            appendHelp(
+                output, "kkmha_arena_upstream_allocations_total", "counter",
+                "Heap allocations made by connection arenas (request parsing only) after their initial buffer "
+                "was exhausted."
+            );
+            appendSample(
+                output, "kkmha_arena_upstream_allocations_total", {},
+                static_cast<double>(stats.m_allocations)
+            );
+            appendHelp(output, "kkmha_arena_upstream_bytes_total", "counter", "Bytes taken from the heap by arenas.");
+            appendSample(output, "kkmha_arena_upstream_bytes_total", {}, static_cast<double>(stats.m_bytes));
+        }
+
+        appendHelp(output, "kkmha_reactor_connections_active", "gauge", "Connections served by the reactor.");
+        for (size_t i = 0; i < s_reactors.size(); ++i) {
+            appendSample(
+                output, "kkmha_reactor_connections_active", std::format("reactor=\"{}\"", i),
+                static_cast<double>(s_reactors[i]->m_active.load())
+            );
+        }
+        appendHelp(output, "kkmha_reactor_accepted_total", "counter", "Connections accepted by the reactor.");
+        for (size_t i = 0; i < s_reactors.size(); ++i) {
+            appendSample(
+                output, "kkmha_reactor_accepted_total", std::format("reactor=\"{}\"", i),
+                static_cast<double>(s_reactors[i]->m_accepted.load())
+            );
+        }
+
+        {
+            const auto stats = s_workerPool.stats();
+            appendHelp(output, "kkmha_worker_pool_busy", "gauge", "Busy worker threads.");
+            appendSample(output, "kkmha_worker_pool_busy", {}, static_cast<double>(stats.m_busy));
+            appendHelp(output, "kkmha_worker_pool_queue_depth", "gauge", "Tasks waiting for a worker thread.");
+            appendSample(output, "kkmha_worker_pool_queue_depth", {}, static_cast<double>(stats.m_queueDepth));
+            appendHelp(output, "kkmha_worker_pool_completed_total", "counter", "Tasks completed by the worker pool.");
+            appendSample(output, "kkmha_worker_pool_completed_total", {}, static_cast<double>(stats.m_completed));
+            appendHelp(output, "kkmha_worker_pool_wait_seconds_total", "counter", "Time tasks spent in the queue.");
+            appendSample(
+                output, "kkmha_worker_pool_wait_seconds_total", {},
+                static_cast<double>(stats.m_waitTotal.count()) / 1e6
+            );
+        }
+
+        {
+            const auto stats = KkmOp::Pool::stats();
+            appendHelp(output, "kkmha_device_pool_total", "counter", "Device connection pool lookups by outcome.");
+            appendSample(output, "kkmha_device_pool_total", "outcome=\"hit\"", static_cast<double>(stats.m_hits));
+            appendSample(output, "kkmha_device_pool_total", "outcome=\"miss\"", static_cast<double>(stats.m_misses));
+            appendHelp(
+                output, "kkmha_device_pool_evictions_total", "counter",
+                "Device connections closed by the pool."
+            );
+            appendSample(output, "kkmha_device_pool_evictions_total", {}, static_cast<double>(stats.m_evictions));
+            appendHelp(output, "kkmha_device_pool_idle", "gauge", "Idle device connections kept open.");
+            appendSample(output, "kkmha_device_pool_idle", {}, static_cast<double>(stats.m_idle));
+        }
+
+        {
+            const auto stats = TlsSession::stats();
+            appendHelp(output, "kkmha_tls_handshakes_total", "counter", "TLS handshakes by kind.");
+            appendSample(output, "kkmha_tls_handshakes_total", "kind=\"full\"", static_cast<double>(stats.m_full));
+            appendSample(
+                output, "kkmha_tls_handshakes_total", "kind=\"resumed\"",
+                static_cast<double>(stats.m_resumed)
+            );
+        }
+    }
+
     void run() {
         assert(s_state.load() == State::Initial);
         LOG_DEBUG_TS(Wcs::c_starting);
@@ -454,13 +922,86 @@ namespace Server {
 
         try {
             {
-                Asio::IoContext ioContext { std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, 4) };
+                s_reactors.clear();
+                for (int64_t i = 0; i < s_ioThreads; ++i) {
+                    s_reactors.emplace_back(std::make_unique<Reactor>());
+                }
+                Deferred::Exec reactorsCleaner { [] { s_reactors.clear(); } };
+                Asio::IoContext & ioContext = s_reactors.front()->m_context;
                 Asio::SignalSet signals(ioContext, SIGINT, SIGTERM);
                 signals.async_wait([] (auto, auto) { std::thread(stop).detach(); });
-                s_hitman.placeOrder([& ioContext] { ioContext.stop(); });
+                s_hitman.placeOrder(
+                    [] {
+                        for (auto & reactor : s_reactors) {
+                            reactor->m_context.stop();
+                        }
+                    }
+                );
+                // Ответы на фискальные команды должны оказаться в кэше до приёма первого запроса.
+                Journal::open();
+                Deferred::Exec journalCloser { [] { Journal::close(); } };
+                Static::Watcher::start();
+                Deferred::Exec watcherStopper { [] { Static::Watcher::stop(); } };
+                s_workerPool.start(s_workerThreads);
+                LOG_DEBUG_TS(Wcs::c_workerPoolStarted, s_workerThreads);
+                KkmOp::startPolling();
+                Deferred::Exec pollingStopper { [] { KkmOp::stopPolling(); } };
                 asio::co_spawn(ioContext, listen(), asio::detached);
-                ioContext.run();
+
+                {
+                    std::vector<std::thread> ioThreads {};
+                    ioThreads.reserve(s_reactors.size() - 1);
+                    Deferred::Exec ioThreadsJoiner {
+                        [& ioThreads] {
+                            for (auto & reactor : s_reactors) {
+                                reactor->m_context.stop();
+                            }
+                            for (auto & thread : ioThreads) {
+                                thread.join();
+                            }
+                        }
+                    };
+                    for (size_t i = 1; i < s_reactors.size(); ++i) {
+                        ioThreads.emplace_back([& context = s_reactors[i]->m_context] { context.run(); });
+                    }
+                    LOG_DEBUG_TS(Wcs::c_reactorsStarted, s_reactors.size());
+                    ioContext.run();
+                }
+
                 s_hitman.cancelOrder();
+                pollingStopper.perform();
+                s_workerPool.stop();
+                KkmOp::Pool::clear();
+                for (size_t i = 0; i < s_reactors.size(); ++i) {
+                    LOG_DEBUG_TS(Wcs::c_reactorSummary, i, s_reactors[i]->m_accepted.load());
+                }
+                LOG_DEBUG_TS(
+                    [] {
+                        const auto stats = s_workerPool.stats();
+                        return std::format(
+                            Wcs::c_workerPoolStopped, stats.m_completed, stats.m_queuePeak,
+                            stats.m_completed ? stats.m_waitTotal.count() / static_cast<int64_t>(stats.m_completed) : 0,
+                            stats.m_waitMax.count()
+                        );
+                    }
+                );
+                LOG_DEBUG_TS(
+                    [] {
+                        const auto stats = s_admission.stats();
+                        return std::format(
+                            Wcs::c_admissionSummary, stats.m_admitted, stats.m_queued, stats.m_queuePeak,
+                            stats.m_overflows, stats.m_timeouts, stats.m_cancellations
+                        );
+                    }
+                );
+                LOG_DEBUG_TS(
+                    [] {
+                        const auto stats = TlsSession::stats();
+                        return std::format(
+                            Wcs::c_tlsSessionsSummary, stats.m_full, stats.m_resumed, stats.m_keyRotations
+                        );
+                    }
+                );
             }
 
             LOG_INFO_TS(Wcs::c_stopped);
@@ -3,7 +3,13 @@
 
 #pragma once
 
+#include <string>
+
 namespace Server {
+    namespace Metrics {
+        void collect(std::string &);
+    }
+
     void run();
     bool start();
     void stop();
@@ -10,21 +10,80 @@ namespace Server {
     constexpr DateTime::SleepUnit c_sleep { DateTime::c_basicSleep }; // Миллисекунды
     constexpr DateTime::SleepUnit c_sleepQuantum { DateTime::c_basicSleepQuantum }; // Миллисекунды
     constexpr DateTime::SleepUnit c_controlTimeout { 30 * DateTime::c_basicSleep }; // Миллисекунды
-    constexpr DateTime::SleepUnit c_closingDelay { 3 * DateTime::c_basicSleep }; // Миллисекунды
-    constexpr int64_t c_delayedSockets { 10'000 };
+    constexpr DateTime::SleepUnit c_rejectTimeout { 3 * DateTime::c_basicSleep }; // Миллисекунды
+    constexpr int64_t c_rejectedSockets { 10'000 };
+    constexpr size_t c_rejectBufferSize { 16'384 };
+    constexpr size_t c_connectionArenaSize { 16'384 };
+    constexpr size_t c_http2ReadBufferSize { 16'384 };
+    constexpr size_t c_http2WriteChunk { 16'384 };
+    constexpr int64_t c_http2MaxConcurrentStreams { 100 };
+    constexpr size_t c_metricsRouteLimit { 64 };
+    constexpr std::string_view c_metricsOtherRoute { "other" };
+    constexpr std::string_view c_metricsMimeType { "text/plain; version=0.0.4; charset=utf-8" };
+    constexpr size_t c_metricsReserve { 32'768 };
     constexpr int64_t c_minRequestTimeout { 6 }; // Секунды
     constexpr int64_t c_maxRequestTimeout { 1'800 }; // Секунды
     constexpr int64_t c_defRequestTimeout { 180 }; // Секунды
+    constexpr int64_t c_minKeepAliveTimeout { 0 }; // Секунды
+    constexpr int64_t c_maxKeepAliveTimeout { 300 }; // Секунды
+    constexpr int64_t c_defKeepAliveTimeout { 15 }; // Секунды
+    constexpr int64_t c_minKeepAliveMaxRequests { 1 };
+    constexpr int64_t c_maxKeepAliveMaxRequests { 10'000 };
+    constexpr int64_t c_defKeepAliveMaxRequests { 100 };
+    constexpr int64_t c_minSessionCacheSize { 0 };
+    constexpr int64_t c_maxSessionCacheSize { 100'000 };
+    constexpr int64_t c_defSessionCacheSize { 1'024 };
+    constexpr int64_t c_minSessionTimeout { 60 }; // Секунды
+    constexpr int64_t c_maxSessionTimeout { 86'400 }; // Секунды
+    constexpr int64_t c_defSessionTimeout { 7'200 }; // Секунды
+    constexpr bool c_defSessionTickets { true };
+    constexpr int64_t c_minTicketKeyRotation { 60 }; // Секунды
+    constexpr int64_t c_maxTicketKeyRotation { 86'400 }; // Секунды
+    constexpr int64_t c_defTicketKeyRotation { 3'600 }; // Секунды
     constexpr bool c_defIpv4Only { false };
+    constexpr bool c_defEnableHttp2 { true };
     constexpr unsigned short c_minPort { 1 };
     constexpr unsigned short c_maxPort { 65'535 };
     constexpr unsigned short c_defPort { 5'757 };
     constexpr int64_t c_minConcurrencyLimit { 2 };
     constexpr int64_t c_maxConcurrencyLimit { 100 };
     constexpr int64_t c_defConcurrencyLimit { 10 };
+    constexpr int64_t c_minAdmissionQueueSize { 0 };
+    constexpr int64_t c_maxAdmissionQueueSize { 1'000 };
+    constexpr int64_t c_defAdmissionQueueSize { 20 };
+    constexpr int64_t c_minAdmissionTimeout { 1 }; // Секунды
+    constexpr int64_t c_maxAdmissionTimeout { 120 }; // Секунды
+    constexpr int64_t c_defAdmissionTimeout { 10 }; // Секунды
+    constexpr int64_t c_minIoThreads { 1 };
+    constexpr int64_t c_maxIoThreads { 64 };
+    constexpr int64_t c_defIoThreads { 2 };
+    constexpr int64_t c_minWorkerThreads { 1 };
+    constexpr int64_t c_maxWorkerThreads { 100 };
+    constexpr int64_t c_defWorkerThreads { 4 };
+    constexpr int64_t c_minDeviceIdleTimeout { 0 }; // Секунды
+    constexpr int64_t c_maxDeviceIdleTimeout { 3'600 }; // Секунды
+    constexpr int64_t c_defDeviceIdleTimeout { 60 }; // Секунды
+    constexpr int64_t c_minStatusPollInterval { 0 }; // Секунды
+    constexpr int64_t c_maxStatusPollInterval { 3'600 }; // Секунды
+    constexpr int64_t c_defStatusPollInterval { 0 }; // Секунды
+    constexpr int64_t c_minCompressionThreshold { 0 }; // Байты
+    constexpr int64_t c_maxCompressionThreshold { 1'048'576 }; // Байты
+    constexpr int64_t c_defCompressionThreshold { 1'024 }; // Байты
+    constexpr int64_t c_minCacheMemoryLimit { 1 }; // Мегабайты
+    constexpr int64_t c_maxCacheMemoryLimit { 4'096 }; // Мегабайты
+    constexpr int64_t c_defCacheMemoryLimit { 64 }; // Мегабайты
     constexpr std::wstring_view c_defCertificateChainFile { L"kkmha.crt" };
     constexpr std::wstring_view c_defPrivateKeyFile { L"kkmha.key" };
-    constexpr size_t c_cacheCleanUpThreshold { 200 };
+    constexpr bool c_defEnableJournal { true };
+    constexpr std::wstring_view c_defJournalFile { L"kkmha.journal" };
+    constexpr size_t c_journalWriteChunk { 1'048'576 }; // Байты
+    constexpr uint64_t c_journalCompactionThreshold { 16'777'216 }; // Байты
+    constexpr size_t c_journalCompactionSlack { 1'024 }; // Записи
+    constexpr size_t c_cacheDeadlinesSlack { 64 };
+    constexpr size_t c_cacheEntryOverhead { 256 }; // Байты: узлы контейнеров, счётчики shared_ptr, сроки
+    constexpr DateTime::Offset c_housekeepingInterval { 5 }; // Секунды
+    constexpr size_t c_cacheStripes { 16 }; // Степень двойки
+    constexpr size_t c_cacheClockSteps { 8 }; // Записи, просматриваемые стрелкой вытеснения в одной полосе за заход
     constexpr std::string_view c_defSecret { "!!! don't forget to change me !!!" };
     constexpr bool c_loopbackWithoutSecret { true };
 }
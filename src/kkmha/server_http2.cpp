@@ -0,0 +1,569 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#include "server_http2.h"
+#include "server_variables.h"
+#include "server_strings.h"
+#include "server_failure.h"
+#include "http_defaults.h"
+#include "http_strings.h"
+#include "http_scanner.h"
+#include <log/write.h>
+#include <openssl/ssl.h>
+#include <array>
+#include <string_view>
+
+#if WITH_HTTP2
+#include <nghttp2/nghttp2.h>
+#include <asio/experimental/awaitable_operators.hpp>
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#endif
+
+namespace Server::Http2 {
+    using namespace std::string_view_literals;
+
+    constexpr std::string_view c_h2 { "h2" };
+
+    // Списки протоколов в формате ALPN: длина и имя, в порядке предпочтения сервера.
+    static constexpr std::array<unsigned char, 12> c_withHttp2 {
+        2, 'h', '2', 8, 'h', 't', 't', 'p', '/', '1', '.', '1'
+    };
+    static constexpr std::array<unsigned char, 9> c_withoutHttp2 { 8, 'h', 't', 't', 'p', '/', '1', '.', '1' };
+
+    static int selectProtocol(
+        SSL * ssl,
+        const unsigned char ** out,
+        unsigned char * outLength,
+        const unsigned char * in,
+        const unsigned int inLength,
+        void *
+    ) {
+        // HTTP/2 запрещает TLS ниже 1.2 (RFC 9113, п. 9.2), поэтому при legacy-TLS предлагаем только http/1.1.
+        const bool http2 { WITH_HTTP2 && s_enableHttp2 && ::SSL_version(ssl) >= TLS1_2_VERSION };
+        const auto protocols = http2 ? c_withHttp2.data() : c_withoutHttp2.data();
+        const auto size = static_cast<unsigned int>(http2 ? c_withHttp2.size() : c_withoutHttp2.size());
+        auto selected = const_cast<unsigned char **>(out); // NOLINT(*-const-cast)
+        if (::SSL_select_next_proto(selected, outLength, protocols, size, in, inLength) != OPENSSL_NPN_NEGOTIATED) {
+            return SSL_TLSEXT_ERR_NOACK;
+        }
+        return SSL_TLSEXT_ERR_OK;
+    }
+
+    void configure(Asio::SslContext & context) {
+        ::SSL_CTX_set_alpn_select_cb(context.native_handle(), selectProtocol, nullptr);
+    }
+
+    bool negotiated(const SSL * ssl) noexcept {
+        const unsigned char * protocol { nullptr };
+        unsigned int length { 0 };
+        ::SSL_get0_alpn_selected(ssl, &protocol, &length);
+        return protocol && std::string_view { reinterpret_cast<const char *>(protocol), length } == c_h2;
+    }
+
+#if WITH_HTTP2
+    struct Stream {
+        Http::Request m_request;
+        Metrics::Timing m_timing {};
+        Http::Wire m_wire {};
+        std::string m_method {};
+        std::string m_target {};
+        std::vector<std::pair<std::string, std::string>> m_fields {};
+        std::string m_body {};
+        std::string m_head {}; // Заголовок ответа; имена полей приведены к нижнему регистру
+        std::vector<nghttp2_nv> m_nva {};
+        std::string_view m_pending {}; // Ещё не отправленная часть тела ответа
+        const int32_t m_id;
+        bool m_bodyTooLarge { false };
+        bool m_tooManyFields { false };
+        bool m_responded { false };
+        bool m_closed { false };
+
+        Stream(const int32_t id, const Asio::IpAddress & remote)
+        : m_request { Asio::IpAddress { remote } }, m_id { id } {}
+    };
+
+    // Поля, которые в HTTP/2 не передаются (RFC 9113, п. 8.2.2).
+    [[nodiscard]]
+    static bool connectionSpecific(const std::string_view name) noexcept {
+        return name == "connection"sv || name == "keep-alive"sv || name == "proxy-connection"sv
+            || name == "transfer-encoding"sv || name == "upgrade"sv;
+    }
+
+    class Session {
+        Asio::Stream & m_stream;
+        const Asio::IpAddress & m_remote;
+        const Exchange & m_exchange;
+        Asio::Timer m_wakeup;
+        Asio::Timer m_timeout;
+        nghttp2_session * m_session { nullptr };
+        std::unordered_map<int32_t, std::shared_ptr<Stream>> m_streams {};
+        std::vector<std::shared_ptr<Stream>> m_ready {};
+        std::string m_output {};
+        Http::Request::IdType m_lastId { 0 };
+        int64_t m_served { 0 };
+        size_t m_running { 0 };
+        bool m_dirty { false };
+        bool m_finished { false };
+        bool m_goingAway { false };
+
+        [[nodiscard]]
+        static Session & self(void * userData) noexcept {
+            return *static_cast<Session *>(userData);
+        }
+
+        [[nodiscard]]
+        Stream * find(const int32_t id) const noexcept {
+            const auto it = m_streams.find(id);
+            return it == m_streams.end() ? nullptr : it->second.get();
+        }
+
+        static int onBeginHeaders(nghttp2_session *, const nghttp2_frame * frame, void * userData) {
+            if (frame->hd.type != NGHTTP2_HEADERS || frame->headers.cat != NGHTTP2_HCAT_REQUEST) {
+                return 0;
+            }
+            auto & session = self(userData);
+            auto stream = std::make_shared<Stream>(frame->hd.stream_id, session.m_remote);
+            session.m_lastId = stream->m_request.m_id;
+            session.m_streams.emplace(frame->hd.stream_id, std::move(stream));
+            return 0;
+        }
+
+        static int onHeader(
+            nghttp2_session *,
+            const nghttp2_frame * frame,
+            const uint8_t * name,
+            const size_t nameLength,
+            const uint8_t * value,
+            const size_t valueLength,
+            uint8_t,
+            void * userData
+        ) {
+            if (frame->hd.type != NGHTTP2_HEADERS || frame->headers.cat != NGHTTP2_HCAT_REQUEST) {
+                return 0;
+            }
+            auto stream = self(userData).find(frame->hd.stream_id);
+            if (!stream) {
+                return 0;
+            }
+            const std::string_view key { reinterpret_cast<const char *>(name), nameLength };
+            const std::string_view text { reinterpret_cast<const char *>(value), valueLength };
+            if (key == ":method"sv) {
+                stream->m_method.assign(text);
+            } else if (key == ":path"sv) {
+                stream->m_target.assign(text);
+            } else if (key.starts_with(':')) {
+                // :scheme и :authority серверу не нужны.
+            } else if (stream->m_fields.size() < Http::Scanner::c_fieldsLimit) {
+                stream->m_fields.emplace_back(key, text);
+            } else {
+                stream->m_tooManyFields = true;
+            }
+            return 0;
+        }
+
+        static int onDataChunk(
+            nghttp2_session *,
+            uint8_t,
+            const int32_t id,
+            const uint8_t * data,
+            const size_t length,
+            void * userData
+        ) {
+            auto stream = self(userData).find(id);
+            if (!stream || stream->m_bodyTooLarge) {
+                return 0;
+            }
+            if (stream->m_body.size() + length > Http::c_requestBodySizeLimit) {
+                stream->m_bodyTooLarge = true;
+                stream->m_body.clear();
+                return 0;
+            }
+            stream->m_body.append(reinterpret_cast<const char *>(data), length);
+            return 0;
+        }
+
+        static int onFrame(nghttp2_session *, const nghttp2_frame * frame, void * userData) {
+            if (
+                (frame->hd.type != NGHTTP2_HEADERS && frame->hd.type != NGHTTP2_DATA)
+                || !(frame->hd.flags & NGHTTP2_FLAG_END_STREAM)
+            ) {
+                return 0;
+            }
+            auto & session = self(userData);
+            if (const auto it = session.m_streams.find(frame->hd.stream_id); it != session.m_streams.end()) {
+                session.m_ready.push_back(it->second);
+            }
+            return 0;
+        }
+
+        static int onStreamClose(nghttp2_session *, const int32_t id, uint32_t, void * userData) {
+            auto & session = self(userData);
+            const auto it = session.m_streams.find(id);
+            if (it == session.m_streams.end()) {
+                return 0;
+            }
+            auto & stream = *it->second;
+            stream.m_closed = true;
+            if (stream.m_responded) {
+                const auto & request = stream.m_request;
+                stream.m_timing.lap(Metrics::Phase::Write);
+                session.m_exchange.m_record(request, stream.m_timing);
+                if (request.m_response.m_status < Http::Status::BadRequest) {
+                    LOG_INFO_TS(Wcs::c_prefixedText, request.m_id, Wcs::c_processingSuccess);
+                } else {
+                    LOG_WARNING_TS(Wcs::c_prefixedText, request.m_id, Wcs::c_processingFailed);
+                }
+            }
+            session.m_streams.erase(it);
+            return 0;
+        }
+
+        static nghttp2_ssize readBody(
+            nghttp2_session *,
+            int32_t,
+            uint8_t * buffer,
+            const size_t length,
+            uint32_t * flags,
+            nghttp2_data_source * source,
+            void *
+        ) {
+            auto & stream = *static_cast<Stream *>(source->ptr);
+            const auto size = std::min(length, stream.m_pending.size());
+            std::memcpy(buffer, stream.m_pending.data(), size);
+            stream.m_pending.remove_prefix(size);
+            if (stream.m_pending.empty()) {
+                *flags |= NGHTTP2_DATA_FLAG_EOF;
+            }
+            return static_cast<nghttp2_ssize>(size);
+        }
+
+        // Запрос собирается после получения всех кадров потока: только тогда хранилище полей
+        // больше не меняется, и на него можно ссылаться.
+        static void complete(Stream & stream) {
+            auto & request = stream.m_request;
+            request.m_verb = stream.m_method;
+            const std::string_view target { stream.m_target };
+            request.m_path = target.substr(0, target.find_first_of("?#"));
+            if (const auto query = target.find('?'); query != std::string_view::npos) {
+                request.m_query = target.substr(query + 1, target.find('#', query) - query - 1);
+            }
+            request.m_keepAlive = true;
+            request.route();
+
+            if (request.m_verb == "GET"sv) {
+                request.m_method = Http::Method::Get;
+            } else if (request.m_verb == "POST"sv) {
+                request.m_method = Http::Method::Post;
+            } else {
+                request.m_response.m_status = Http::Status::NotImplemented;
+            }
+            if (request.m_path.empty() || stream.m_tooManyFields) {
+                request.m_response.m_status = Http::Status::BadRequest;
+            }
+            if (stream.m_bodyTooLarge) {
+                LOG_ERROR_TS(Http::Wcs::c_bodySizeLimitExceeded, request.m_id);
+                request.m_response.m_status = Http::Status::BadRequest;
+                request.m_response.m_data.emplace<1>(Http::Mbs::c_bodySizeLimitExceeded);
+            }
+
+            if (request.m_response.m_status != Http::Status::Ok) {
+                if (request.emptyResponse()) {
+                    request.m_response.m_data = Http::Mbs::c_statusStrings.at(request.m_response.m_status);
+                }
+                return;
+            }
+
+            if (request.m_method == Http::Method::Post) {
+                request.m_body = stream.m_body;
+            }
+            request.m_header.reserve(stream.m_fields.size());
+            for (const auto & [name, value] : stream.m_fields) {
+                request.m_header.emplace(Http::classify(name), name, value);
+            }
+        }
+
+        // Ответ формируется теми же средствами, что и для HTTP/1.1, затем заголовок переводится в пары
+        // имя-значение HTTP/2. Строки ссылаются на m_head и тело в m_wire, которые живут до закрытия потока.
+        void respond(Stream & stream) {
+            const auto [head, body] = stream.m_wire.parts();
+            stream.m_head.assign(head);
+            std::string_view text { stream.m_head };
+
+            auto line = text.substr(0, text.find(Http::Mbs::c_crlf));
+            const auto status = line.substr(Http::Mbs::c_statusLinePrefix.size(), 3);
+            stream.m_nva.reserve(16);
+            stream.m_nva.push_back(
+                {
+                    const_cast<uint8_t *>(reinterpret_cast<const uint8_t *>(":status")), // NOLINT(*-const-cast)
+                    const_cast<uint8_t *>(reinterpret_cast<const uint8_t *>(status.data())), // NOLINT(*-const-cast)
+                    7, status.size(), NGHTTP2_NV_FLAG_NO_COPY_NAME | NGHTTP2_NV_FLAG_NO_COPY_VALUE
+                }
+            );
+
+            for (
+                auto first = line.size() + Http::Mbs::c_crlf.size();
+                first < text.size();
+                first += line.size() + Http::Mbs::c_crlf.size()
+            ) {
+                line = text.substr(first, text.find(Http::Mbs::c_crlf, first) - first);
+                const auto colon = line.find(':');
+                if (line.empty() || colon == std::string_view::npos) {
+                    break;
+                }
+                auto name = stream.m_head.data() + first;
+                std::transform(name, name + colon, name, [] (const char ch) { return Hash::lowered(ch); });
+                auto value = line.substr(colon + 1);
+                value.remove_prefix(std::min(value.find_first_not_of(' '), value.size()));
+                if (connectionSpecific({ name, colon })) {
+                    continue;
+                }
+                stream.m_nva.push_back(
+                    {
+                        reinterpret_cast<uint8_t *>(name),
+                        const_cast<uint8_t *>(reinterpret_cast<const uint8_t *>(value.data())), // NOLINT(*-const-cast)
+                        colon, value.size(), NGHTTP2_NV_FLAG_NO_COPY_NAME | NGHTTP2_NV_FLAG_NO_COPY_VALUE
+                    }
+                );
+            }
+
+            stream.m_pending = body;
+            nghttp2_data_provider2 provider { .source = { .ptr = &stream }, .read_callback = readBody };
+            const auto result
+                = ::nghttp2_submit_response2(
+                    m_session, stream.m_id, stream.m_nva.data(), stream.m_nva.size(), body.empty() ? nullptr : &provider
+                );
+            if (result != 0) {
+                LOG_ERROR_TS(
+                    Mbs::c_prefixedOperation, stream.m_request.m_id, Mbs::c_http2Operation, ::nghttp2_strerror(result)
+                );
+                ::nghttp2_submit_rst_stream(m_session, NGHTTP2_FLAG_NONE, stream.m_id, NGHTTP2_INTERNAL_ERROR);
+            } else {
+                stream.m_responded = true;
+            }
+        }
+
+        asio::awaitable<void> handle(std::shared_ptr<Stream> stream) noexcept {
+            auto & request = stream->m_request;
+            try {
+                complete(*stream);
+                stream->m_timing.lap(Metrics::Phase::Parse);
+                co_await m_exchange.m_process(request, stream->m_timing);
+            } catch (const Basic::Failure & e) {
+                request.m_response.m_status = Http::Status::InternalServerError;
+                LOG_ERROR_TS(e);
+            } catch (const std::exception & e) {
+                request.m_response.m_status = Http::Status::InternalServerError;
+                LOG_ERROR_TS(e);
+            } catch (...) {
+                request.m_response.m_status = Http::Status::InternalServerError;
+                LOG_ERROR_TS(Basic::Wcs::c_somethingWrong);
+            }
+
+            if (!m_finished && !stream->m_closed) {
+                try {
+                    m_exchange.m_render(request, stream->m_wire, true);
+                    respond(*stream);
+                } catch (...) {
+                    ::nghttp2_submit_rst_stream(m_session, NGHTTP2_FLAG_NONE, stream->m_id, NGHTTP2_INTERNAL_ERROR);
+                }
+                ++m_served;
+                signal();
+            }
+            --m_running;
+
+            co_return;
+        }
+
+        void signal() noexcept {
+            m_dirty = true;
+            m_wakeup.cancel();
+        }
+
+        // Исчерпан лимит запросов соединения или сервер останавливается: новые потоки не принимаются,
+        // начатые дообслуживаются, после чего соединение закрывается.
+        void goAwayIfNeeded() noexcept {
+            if (m_goingAway || (m_served < s_keepAliveMaxRequests && m_exchange.m_accepting())) {
+                return;
+            }
+            m_goingAway = true;
+            ::nghttp2_submit_goaway(
+                m_session, NGHTTP2_FLAG_NONE, ::nghttp2_session_get_last_proc_stream_id(m_session),
+                NGHTTP2_NO_ERROR, nullptr, 0
+            );
+        }
+
+        void armTimeout() {
+            const auto seconds = m_running > 0 || s_keepAliveTimeout == 0 ? s_requestTimeout : s_keepAliveTimeout;
+            m_timeout.expires_after(std::chrono::seconds(seconds));
+            m_timeout.async_wait(
+                [this] (const Asio::Error error) {
+                    // Перезаведённый таймер отменяет прежнее ожидание; проверка срока отсекает уже
+                    // поставленное в очередь срабатывание.
+                    if (!error && m_timeout.expiry() <= Asio::Timer::clock_type::now()) {
+                        LOG_DEBUG_TS(Wcs::c_prefixedText, m_lastId, Wcs::c_keepAliveClosed);
+                        Asio::Error ignored {};
+                        m_stream.lowest_layer().cancel(ignored); // NOLINT(*-unused-return-value)
+                    }
+                }
+            );
+        }
+
+        [[nodiscard]]
+        bool active() const noexcept {
+            return ::nghttp2_session_want_read(m_session) || ::nghttp2_session_want_write(m_session);
+        }
+
+        asio::awaitable<void> read() {
+            const auto executor = co_await asio::this_coro::executor;
+            std::array<uint8_t, c_http2ReadBufferSize> buffer; // NOLINT(*-member-init)
+            Asio::Error error {};
+
+            while (!m_finished && active()) {
+                armTimeout();
+                const auto size
+                    = co_await m_stream.async_read_some(
+                        asio::buffer(buffer), asio::redirect_error(asio::use_awaitable, error)
+                    );
+                if (error) {
+                    break;
+                }
+                const auto result = ::nghttp2_session_mem_recv2(m_session, buffer.data(), size);
+                if (result < 0) {
+                    LOG_ERROR_TS(
+                        Mbs::c_prefixedOperation, m_lastId, Mbs::c_http2Operation,
+                        ::nghttp2_strerror(static_cast<int>(result))
+                    );
+                    break;
+                }
+                for (auto & stream : m_ready) {
+                    ++m_running;
+                    asio::co_spawn(executor, handle(std::move(stream)), asio::detached);
+                }
+                m_ready.clear();
+                goAwayIfNeeded();
+                signal();
+            }
+
+            m_timeout.cancel();
+            m_finished = true;
+            signal();
+        }
+
+        asio::awaitable<void> write() {
+            Asio::Error error {};
+
+            while (!m_finished || ::nghttp2_session_want_write(m_session)) {
+                m_dirty = false;
+                goAwayIfNeeded();
+                for (;;) {
+                    const uint8_t * data { nullptr };
+                    const auto size = ::nghttp2_session_mem_send2(m_session, &data);
+                    if (size < 0) {
+                        LOG_ERROR_TS(
+                            Mbs::c_prefixedOperation, m_lastId, Mbs::c_http2Operation,
+                            ::nghttp2_strerror(static_cast<int>(size))
+                        );
+                        m_finished = true;
+                        break;
+                    }
+                    if (size > 0) {
+                        m_output.append(reinterpret_cast<const char *>(data), static_cast<size_t>(size));
+                    }
+                    if (size == 0 || m_output.size() >= c_http2WriteChunk) {
+                        if (m_output.empty()) {
+                            break;
+                        }
+                        co_await asio::async_write(
+                            m_stream, asio::buffer(m_output), asio::redirect_error(asio::use_awaitable, error)
+                        );
+                        m_output.clear();
+                        if (error) {
+                            m_finished = true;
+                            break;
+                        }
+                    }
+                }
+
+                if (m_finished || !active()) {
+                    break;
+                }
+                if (!m_dirty) {
+                    m_wakeup.expires_at(Asio::Timer::time_point::max());
+                    co_await m_wakeup.async_wait(asio::redirect_error(asio::use_awaitable, error));
+                }
+            }
+
+            // Чтение могло остаться в ожидании данных от клиента - прерываем его.
+            m_finished = true;
+            Asio::Error ignored {};
+            m_stream.lowest_layer().cancel(ignored); // NOLINT(*-unused-return-value)
+        }
+
+    public:
+        Session(
+            const Asio::Executor & executor,
+            Asio::Stream & stream,
+            const Asio::IpAddress & remote,
+            const Exchange & exchange
+        ) : m_stream { stream }, m_remote { remote }, m_exchange { exchange },
+          m_wakeup { executor }, m_timeout { executor } {
+            nghttp2_session_callbacks * callbacks { nullptr };
+            if (::nghttp2_session_callbacks_new(&callbacks) != 0) {
+                throw Failure(Mbs::c_http2Operation, asio::error::no_memory); // NOLINT(*-exception-baseclass)
+            }
+            ::nghttp2_session_callbacks_set_on_begin_headers_callback(callbacks, onBeginHeaders);
+            ::nghttp2_session_callbacks_set_on_header_callback(callbacks, onHeader);
+            ::nghttp2_session_callbacks_set_on_data_chunk_recv_callback(callbacks, onDataChunk);
+            ::nghttp2_session_callbacks_set_on_frame_recv_callback(callbacks, onFrame);
+            ::nghttp2_session_callbacks_set_on_stream_close_callback(callbacks, onStreamClose);
+            const auto result = ::nghttp2_session_server_new(&m_session, callbacks, this);
+            ::nghttp2_session_callbacks_del(callbacks);
+            if (result != 0) {
+                throw Failure(Mbs::c_http2Operation, asio::error::no_memory); // NOLINT(*-exception-baseclass)
+            }
+
+            const std::array settings {
+                nghttp2_settings_entry {
+                    NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS, static_cast<uint32_t>(c_http2MaxConcurrentStreams)
+                }
+            };
+            ::nghttp2_submit_settings(m_session, NGHTTP2_FLAG_NONE, settings.data(), settings.size());
+        }
+
+        Session(const Session &) = delete;
+        Session(Session &&) = delete;
+
+        ~Session() {
+            ::nghttp2_session_del(m_session);
+        }
+
+        Session & operator=(const Session &) = delete;
+        Session & operator=(Session &&) = delete;
+
+        asio::awaitable<void> run() {
+            using namespace asio::experimental::awaitable_operators;
+
+            co_await (read() && write());
+
+            // Обработчики потоков ссылаются на сессию: дожидаемся их завершения.
+            Asio::Timer timer { co_await asio::this_coro::executor };
+            while (m_running > 0) {
+                timer.expires_after(c_sleepQuantum);
+                co_await timer.async_wait(asio::use_awaitable);
+            }
+        }
+    };
+
+    asio::awaitable<void> serve(Asio::Stream & stream, const Asio::IpAddress & remote, const Exchange & exchange) {
+        Session session { co_await asio::this_coro::executor, stream, remote, exchange };
+        co_await session.run();
+    }
+#endif
+}
@@ -0,0 +1,31 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#pragma once
+
+#include <cmake/options.h>
+#include "asio.h"
+#include "http_request.h"
+#include "http_wire.h"
+#include "server_metrics.h"
+
+namespace Server::Http2 {
+    // Обработка разобранного запроса, общая для HTTP/1.1 и HTTP/2 (реализована в server_core.cpp).
+    struct Exchange {
+        asio::awaitable<void> (* m_process)(Http::Request &, Metrics::Timing &);
+        void (* m_render)(Http::Request &, Http::Wire &, bool keepAlive);
+        void (* m_record)(const Http::Request &, Metrics::Timing &);
+        bool (* m_accepting)() noexcept; // Сервер принимает новые запросы
+    };
+
+    // Выбор протокола прикладного уровня (ALPN): h2, если он разрешён и поддерживается клиентом,
+    // иначе http/1.1.
+    void configure(Asio::SslContext &);
+    [[nodiscard]] bool negotiated(const SSL *) noexcept;
+
+#if WITH_HTTP2
+    // Обслуживает соединение после TLS-рукопожатия, на котором согласован h2. Потоки (streams)
+    // обрабатываются параллельно, ответы отправляются по мере готовности.
+    asio::awaitable<void> serve(Asio::Stream &, const Asio::IpAddress &, const Exchange &);
+#endif
+}
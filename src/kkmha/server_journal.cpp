@@ -0,0 +1,421 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#include "server_journal.h"
+#include "server_cache_core.h"
+#include "server_defaults.h"
+#include "server_variables.h"
+#include "server_strings.h"
+#include <lib/winapi.h>
+#include <lib/errexp.h>
+#include <lib/except.h>
+#include <lib/text.h>
+#include <log/write.h>
+#include <zlib.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace Server::Journal {
+    // Формат файла: сигнатура с номером версии, затем записи. Запись - заголовок (размер и CRC-32
+    // содержимого), фиксированная часть и байты переменной длины: ключ, ответ, сжатый ответ.
+    // Запись, оборванная сбоем при дозаписи, не проходит проверку CRC или длины и вместе со всем,
+    // что за ней следует, отбрасывается при восстановлении.
+    constexpr std::string_view c_signature { "KKMHAJ\x01\n", 8 };
+
+    struct Head {
+        uint32_t m_size;
+        uint32_t m_crc;
+    };
+
+    struct Fixed {
+        int64_t m_expiredAt; // Секунды от начала эпохи
+        uint32_t m_keySize;
+        uint32_t m_plainSize;
+        uint32_t m_plainStatusLineSize;
+        uint32_t m_gzippedSize;
+        uint32_t m_gzippedStatusLineSize;
+        uint16_t m_status;
+        uint8_t m_keepAliveReady;
+        uint8_t m_reserved;
+    };
+
+    static_assert(sizeof(Head) == 8);
+    static_assert(sizeof(Fixed) == 32);
+
+    using Records = std::unordered_map<Cache::Key, Cache::Entry>;
+
+    static std::mutex s_mutex {};
+    static std::condition_variable s_flushed {};
+    static ::HANDLE s_file { INVALID_HANDLE_VALUE };
+    static std::filesystem::path s_path {};
+    static std::string s_pending {};
+    static uint64_t s_appended { 0 };
+    static uint64_t s_durable { 0 };
+    static uint64_t s_fileSize { 0 };
+    static uint64_t s_compactedSize { 0 };
+    static bool s_busy { false }; // Порция записей сбрасывается на диск
+
+    [[nodiscard]]
+    static uint32_t checksum(const std::string_view data) noexcept {
+        return static_cast<uint32_t>(
+            ::crc32(0, reinterpret_cast<const Bytef *>(data.data()), static_cast<uInt>(data.size()))
+        );
+    }
+
+    template<class T>
+    static void put(std::string & output, const T & value) {
+        output.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    static void encode(std::string & output, const Cache::Key & key, const Cache::Entry & entry) {
+        const auto & response = *entry.m_data;
+        const Fixed fixed {
+            .m_expiredAt
+                = std::chrono::duration_cast<std::chrono::seconds>(entry.m_expiredAt.time_since_epoch()).count(),
+            .m_keySize = static_cast<uint32_t>(key.size()),
+            .m_plainSize = static_cast<uint32_t>(response.m_plain.m_bytes.size()),
+            .m_plainStatusLineSize = static_cast<uint32_t>(response.m_plain.m_statusLineSize),
+            .m_gzippedSize = static_cast<uint32_t>(response.m_gzipped.m_bytes.size()),
+            .m_gzippedStatusLineSize = static_cast<uint32_t>(response.m_gzipped.m_statusLineSize),
+            .m_status = static_cast<uint16_t>(entry.m_status),
+            .m_keepAliveReady = static_cast<uint8_t>(response.m_keepAliveReady),
+            .m_reserved = 0
+        };
+
+        const auto headOffset = output.size();
+        put(output, Head {});
+        const auto payloadOffset = output.size();
+        put(output, fixed);
+        output.append(key);
+        output.append(response.m_plain.m_bytes);
+        output.append(response.m_gzipped.m_bytes);
+
+        const std::string_view payload { std::string_view { output }.substr(payloadOffset) };
+        const Head head { static_cast<uint32_t>(payload.size()), checksum(payload) };
+        std::memcpy(output.data() + headOffset, &head, sizeof(head));
+    }
+
+    // Разбирает содержимое файла; возвращает размер неповреждённой части.
+    template<class F>
+    static size_t decode(const std::string_view data, F && consume) {
+        if (!data.starts_with(c_signature)) {
+            return 0;
+        }
+
+        size_t offset { c_signature.size() };
+        while (data.size() - offset >= sizeof(Head) + sizeof(Fixed)) {
+            Head head {};
+            std::memcpy(&head, data.data() + offset, sizeof(head));
+            if (head.m_size < sizeof(Fixed) || data.size() - offset - sizeof(Head) < head.m_size) {
+                break;
+            }
+            const auto payload = data.substr(offset + sizeof(Head), head.m_size);
+            if (checksum(payload) != head.m_crc) {
+                break;
+            }
+
+            Fixed fixed {};
+            std::memcpy(&fixed, payload.data(), sizeof(fixed));
+            const auto variable = payload.substr(sizeof(Fixed));
+            if (static_cast<uint64_t>(fixed.m_keySize) + fixed.m_plainSize + fixed.m_gzippedSize != variable.size()) {
+                break;
+            }
+
+            consume(fixed, variable);
+            offset += sizeof(Head) + head.m_size;
+        }
+        return offset;
+    }
+
+    [[nodiscard]]
+    static std::string readAll(const std::filesystem::path & path) {
+        std::error_code error {};
+        const auto size = std::filesystem::file_size(path, error);
+        if (error) {
+            return {};
+        }
+        std::ifstream file { path, std::ios::binary };
+        if (!file) {
+            throw Basic::Failure(LIB_WFMT(Basic::Wcs::c_couldntReadFile, path.native())); // NOLINT(*-exception-baseclass)
+        }
+        std::string data(static_cast<size_t>(size), '\0');
+        if (!file.read(data.data(), static_cast<std::streamsize>(data.size()))) {
+            throw Basic::Failure(LIB_WFMT(Basic::Wcs::c_couldntReadFile, path.native())); // NOLINT(*-exception-baseclass)
+        }
+        return data;
+    }
+
+    // Актуальные записи: последние по каждому ключу и с неистёкшим сроком.
+    [[nodiscard]]
+    static Records load(const std::string_view data, size_t & valid, size_t & total) {
+        const auto now = DateTime::Clock::now();
+        Records records {};
+        total = 0;
+        valid = decode(
+            data,
+            [&records, &total, now] (const Fixed & fixed, const std::string_view variable) {
+                ++total;
+                const DateTime::Point expiredAt { std::chrono::seconds(fixed.m_expiredAt) };
+                std::string key { variable.substr(0, fixed.m_keySize) };
+                if (expiredAt <= now) {
+                    records.erase(key);
+                    return;
+                }
+                auto response = std::make_shared<Http::SerializedResponse>(
+                    Http::SerializedResponse::Bytes {
+                        std::string { variable.substr(fixed.m_keySize, fixed.m_plainSize) },
+                        fixed.m_plainStatusLineSize
+                    },
+                    Http::SerializedResponse::Bytes {
+                        std::string { variable.substr(fixed.m_keySize + fixed.m_plainSize, fixed.m_gzippedSize) },
+                        fixed.m_gzippedStatusLineSize
+                    },
+                    fixed.m_keepAliveReady != 0
+                );
+                records.insert_or_assign(
+                    std::move(key),
+                    Cache::Entry {
+                        .m_data = std::move(response),
+                        .m_cachedAt = now,
+                        .m_expiredAt = expiredAt,
+                        .m_status = static_cast<Http::Status>(fixed.m_status),
+                        .m_priority = Cache::Priority::Durable
+                    }
+                );
+            }
+        );
+        return records;
+    }
+
+    static void writeAll(const ::HANDLE file, std::string_view data) {
+        while (!data.empty()) {
+            ::DWORD written { 0 };
+            const auto chunk = static_cast<::DWORD>(std::min<size_t>(data.size(), c_journalWriteChunk));
+            if (!::WriteFile(file, data.data(), chunk, &written, nullptr)) {
+                throw Basic::Failure(System::explainError(L"WriteFile")); // NOLINT(*-exception-baseclass)
+            }
+            data = data.substr(written);
+        }
+    }
+
+    static void flush(const ::HANDLE file) {
+        if (!::FlushFileBuffers(file)) {
+            throw Basic::Failure(System::explainError(L"FlushFileBuffers")); // NOLINT(*-exception-baseclass)
+        }
+    }
+
+    static ::HANDLE openFile(const std::filesystem::path & path, const ::DWORD disposition) {
+        const auto file
+            = ::CreateFileW(
+                path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, disposition, FILE_ATTRIBUTE_NORMAL, nullptr
+            );
+        if (file == INVALID_HANDLE_VALUE) {
+            throw Basic::Failure(System::explainError(L"CreateFileW")); // NOLINT(*-exception-baseclass)
+        }
+        return file;
+    }
+
+    static void closeFile() noexcept {
+        if (s_file != INVALID_HANDLE_VALUE) {
+            ::CloseHandle(s_file);
+            s_file = INVALID_HANDLE_VALUE;
+        }
+    }
+
+    static void openForAppend(const uint64_t size) {
+        s_file = openFile(s_path, OPEN_EXISTING);
+        ::LARGE_INTEGER end {};
+        end.QuadPart = static_cast<::LONGLONG>(size);
+        if (!::SetFilePointerEx(s_file, end, nullptr, FILE_BEGIN)) {
+            throw Basic::Failure(System::explainError(L"SetFilePointerEx")); // NOLINT(*-exception-baseclass)
+        }
+        s_fileSize = s_compactedSize = size;
+    }
+
+    // Новый файл записывается рядом и атомарно подменяет прежний, поэтому сбой во время перестроения
+    // оставляет на диске один из двух целых вариантов журнала.
+    static void rewrite(const Records & records) {
+        std::string data { c_signature };
+        for (const auto & [key, entry] : records) {
+            encode(data, key, entry);
+        }
+
+        auto temporary { s_path };
+        temporary += L".tmp";
+        {
+            const auto file = openFile(temporary, CREATE_ALWAYS);
+            try {
+                writeAll(file, data);
+                flush(file);
+            } catch (...) {
+                ::CloseHandle(file);
+                throw;
+            }
+            ::CloseHandle(file);
+        }
+
+        closeFile();
+        if (!::MoveFileExW(temporary.c_str(), s_path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+            throw Basic::Failure(System::explainError(L"MoveFileExW")); // NOLINT(*-exception-baseclass)
+        }
+        openForAppend(data.size());
+    }
+
+    static void disable(const std::wstring & reason) noexcept {
+        LOG_ERROR_TS(Wcs::c_journalFailed, reason);
+        closeFile();
+    }
+
+    void open() {
+        if (!s_enableJournal) {
+            return;
+        }
+
+        try {
+            const auto started = std::chrono::steady_clock::now();
+            s_path = s_journalFile;
+            const auto data = readAll(s_path);
+            size_t valid { 0 }, total { 0 };
+            const auto records = load(data, valid, total);
+            for (const auto & [key, entry] : records) {
+                Cache::store(key, entry);
+            }
+            const auto elapsed = std::chrono::steady_clock::now() - started;
+            LOG_INFO_TS(
+                Wcs::c_journalReplayed, records.size(), total,
+                std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()
+            );
+
+            std::scoped_lock lock(s_mutex);
+            if (valid < data.size() && !data.empty()) {
+                LOG_WARNING_TS(Wcs::c_journalDamaged, data.size() - valid);
+            }
+            if (valid != data.size() || valid == 0 || total > records.size() * 2 + c_journalCompactionSlack) {
+                rewrite(records);
+            } else {
+                openForAppend(data.size());
+            }
+        } catch (const Basic::Failure & e) {
+            disable(e.explain());
+        } catch (const std::exception & e) {
+            disable(Text::convert(e.what()));
+        } catch (...) {
+            disable(std::wstring { Basic::Wcs::c_somethingWrong });
+        }
+    }
+
+    void close() noexcept {
+        std::unique_lock lock(s_mutex);
+        s_flushed.wait(lock, [] { return !s_busy; });
+        if (s_file != INVALID_HANDLE_VALUE && !s_pending.empty()) {
+            try {
+                writeAll(s_file, s_pending);
+                flush(s_file);
+            } catch (const Basic::Failure & e) {
+                LOG_ERROR_TS(Wcs::c_journalFailed, e.explain());
+            } catch (...) {
+                LOG_ERROR_TS(Wcs::c_journalFailed, Basic::Wcs::c_somethingWrong);
+            }
+        }
+        s_pending.clear();
+        s_durable = s_appended;
+        closeFile();
+        s_flushed.notify_all();
+    }
+
+    void append(const Cache::Key & key, const Cache::Entry & entry) {
+        if (!entry.m_data) {
+            return;
+        }
+
+        std::unique_lock lock(s_mutex);
+        if (s_file == INVALID_HANDLE_VALUE) {
+            return;
+        }
+        encode(s_pending, key, entry);
+        const auto ticket = ++s_appended;
+
+        // Групповая фиксация: первый освободившийся поток записывает и сбрасывает на диск всё, что
+        // накопилось, остальные ждут, пока их запись окажется в сброшенной порции.
+        while (s_durable < ticket) {
+            if (s_busy) {
+                s_flushed.wait(lock);
+                continue;
+            }
+            if (s_file == INVALID_HANDLE_VALUE) {
+                break;
+            }
+            s_busy = true;
+            std::string batch {};
+            batch.swap(s_pending);
+            const auto last = s_appended;
+            lock.unlock();
+
+            std::wstring failure {};
+            try {
+                writeAll(s_file, batch);
+                flush(s_file);
+            } catch (const Basic::Failure & e) {
+                failure = e.explain();
+            } catch (...) {
+                failure = Basic::Wcs::c_somethingWrong;
+            }
+
+            lock.lock();
+            s_busy = false;
+            s_durable = last;
+            s_fileSize += batch.size();
+            if (!failure.empty()) {
+                disable(failure);
+            }
+            s_flushed.notify_all();
+        }
+    }
+
+    void compact() {
+        std::unique_lock lock(s_mutex);
+        if (s_file == INVALID_HANDLE_VALUE
+            || s_fileSize < c_journalCompactionThreshold || s_fileSize < s_compactedSize * 2) {
+            return;
+        }
+        // Перестроение идёт под блокировкой: дозапись приостанавливается, а новые записи попадут уже
+        // в новый файл.
+        s_flushed.wait(lock, [] { return !s_busy; });
+
+        std::wstring failure {};
+        try {
+            const auto data = readAll(s_path);
+            size_t valid { 0 }, total { 0 };
+            const auto records = load(data, valid, total);
+            const auto before = s_fileSize;
+            rewrite(records);
+            LOG_DEBUG_TS(Wcs::c_journalCompacted, before, s_fileSize, records.size());
+        } catch (const Basic::Failure & e) {
+            failure = e.explain();
+        } catch (const std::exception & e) {
+            failure = Text::convert(e.what());
+        } catch (...) {
+            failure = Basic::Wcs::c_somethingWrong;
+        }
+
+        if (!failure.empty()) {
+            disable(failure);
+            s_flushed.notify_all();
+        }
+    }
+
+    bool enabled() noexcept {
+        std::scoped_lock lock(s_mutex);
+        return s_file != INVALID_HANDLE_VALUE;
+    }
+}
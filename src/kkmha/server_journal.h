@@ -0,0 +1,26 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#pragma once
+
+#include "server_cache_types.h"
+#include <cstddef>
+
+// Журнал идемпотентности: ответы на фискальные команды, сохранённые в кэше под ключом идемпотентности,
+// дописываются в файл и переживают перезапуск службы. Повтор запроса с тем же ключом после сбоя
+// получает сохранённый ответ, а не печатает чек ещё раз.
+namespace Server::Journal {
+    // Восстанавливает записи журнала в кэш и открывает журнал для дозаписи. При ошибке журнал
+    // отключается, сервер продолжает работать только с кэшем в памяти.
+    void open();
+    void close() noexcept;
+
+    // Возвращает управление после того, как запись сброшена на диск. Одновременные вызовы
+    // объединяются в одну операцию записи и сброса.
+    void append(const Cache::Key &, const Cache::Entry &);
+
+    // Переписывает журнал без истёкших и заменённых записей, если их накопилось много.
+    void compact();
+
+    [[nodiscard]] bool enabled() noexcept;
+}
@@ -10,4 +10,7 @@ namespace Server::KkmOp {
 
     constexpr DateTime::Offset c_reportCacheLifeTime { 5s }; // Секунды
     constexpr DateTime::Offset c_receiptCacheLifeTime { 345'600s }; // Секунды
+    constexpr int64_t c_snapshotStaleness { 3 }; // Интервалы опроса, после которых снимок состояния не отдаётся
+    constexpr int64_t c_snapshotIdleness { 10 }; // Интервалы опроса без чтения снимка, после которых опрос прекращается
+    constexpr DateTime::Offset c_pollTick { 1s }; // Секунды между проверками, не пора ли обновить снимки
 }
@@ -4,18 +4,35 @@
 #include "server_kkmop_handler.h"
 #include "server_kkmop_defauls.h"
 #include "server_kkmop_strings.h"
+#include "server_kkmop_pool.h"
 #include "server_cache_strings.h"
 #include "server_cache_core.h"
+#include "server_journal.h"
+#include "server_variables.h"
 #include "http_constant_response.h"
 #include "http_json_response.h"
+#include "http_serialized_response.h"
+#include "http_aged_response.h"
 #include <lib/meta.h>
 #include <debug/memprof.h>
 #include <kkm/strings.h>
 #include <kkm/device.h>
 #include <kkm/callhelpers.h>
+#include <kkm/operations.h>
+#include <lib/defer.h>
 #include <cassert>
 #include <utility>
+#include <tuple>
 #include <memory>
+#include <functional>
+#include <array>
+#include <map>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <semaphore>
+#include <thread>
 #include <unordered_map>
 
 namespace Server::KkmOp {
@@ -33,6 +50,7 @@ namespace Server::KkmOp {
         DateTime::Offset m_expiresAfter;
         Http::Status m_status { Http::Status::Ok };
         const Id m_requestId;
+        const bool m_polled; // Фоновый опрос состояния: номер из собственной последовательности, не номер запроса
 
         Payload() = delete;
 
@@ -40,10 +58,11 @@ namespace Server::KkmOp {
             std::string && serialNumber,
             Nln::Json && details,
             const Id requestId,
-            const DateTime::Offset expiresAfter = 0s
+            const DateTime::Offset expiresAfter = 0s,
+            const bool polled = false
         ) : m_serialNumber(std::forward<std::string>(serialNumber)),
             m_details(std::forward<Nln::Json>(details)), m_result(std::nullopt),
-            m_expiresAfter(expiresAfter), m_requestId(requestId) {
+            m_expiresAfter(expiresAfter), m_requestId(requestId), m_polled(polled) {
             assert(m_details.is_object());
         }
 
@@ -54,6 +73,15 @@ namespace Server::KkmOp {
         Payload & operator=(const Payload &) = delete;
         Payload & operator=(Payload &&) = delete;
 
+        // Префикс строк журнала, которые пишет устройство при выполнении операции.
+        [[nodiscard]]
+        std::wstring prefix() const {
+            if (m_polled) {
+                return std::format(Wcs::c_pollPrefix, m_requestId);
+            }
+            return std::format(Wcs::c_requestPrefix, m_requestId);
+        }
+
         [[maybe_unused]]
         void fail(
             const Http::Status status,
@@ -68,13 +96,266 @@ namespace Server::KkmOp {
             m_result.value()[Json::Mbs::c_successKey] = false;
             m_result.value()[Json::Mbs::c_messageKey] = message;
             if (Log::s_appendLocation) {
-                LOG_ERROR_TS(Server::Mbs::c_prefixedTextWithSource, m_requestId, message, SrcLoc::toMbs(location));
+                LOG_ERROR_TS(
+                    m_polled ? Mbs::c_pollPrefixedTextWithSource : Server::Mbs::c_prefixedTextWithSource,
+                    m_requestId, message, SrcLoc::toMbs(location)
+                );
             } else {
-                LOG_ERROR_TS(Server::Mbs::c_prefixedText, m_requestId, message);
+                LOG_ERROR_TS(m_polled ? Mbs::c_pollPrefixedText : Server::Mbs::c_prefixedText, m_requestId, message);
+            }
+        }
+    };
+
+    using Method = void (*)(Payload &);
+    using Then = std::function<void()>;
+
+    struct Follower {
+        std::shared_ptr<Payload> m_payload;
+        Then m_then;
+    };
+
+    // Обмен с устройством, к которому присоединяются идентичные запросы на чтение.
+    struct Joint {
+        std::vector<Follower> m_followers {};
+    };
+
+    struct Step {
+        Operation m_key {};
+        Method m_method { nullptr };
+        std::shared_ptr<Payload> m_payload {};
+        Then m_then {};
+        std::shared_ptr<Joint> m_joint {};
+    };
+
+    // Очередь операций одной ККМ: операции выполняются строго в порядке поступления, ожидающие
+    // идентичные запросы на чтение объединяются в один обмен с устройством. Поток пула занимает только
+    // владелец очереди; остальные операции ждут в ней в виде продолжений и выполняются владельцем.
+    struct Lane {
+        std::deque<Step> m_steps {};
+        std::unordered_map<Operation, std::shared_ptr<Joint>> m_pending {};
+        bool m_owned { false };
+    };
+
+    static std::unordered_map<std::string, Lane> s_lanes {};
+    static std::mutex s_lanesMutex {};
+
+    void performMethod(const Method method, Payload & payload) {
+        try {
+            method(payload);
+        } catch (const Basic::Failure & e) {
+            payload.fail(Http::Status::InternalServerError, Text::convert(e.what()), e.where());
+        } catch (const std::exception & e) {
+            payload.fail(Http::Status::InternalServerError, e.what());
+        } catch (...) {
+            payload.fail(Http::Status::InternalServerError, Basic::Mbs::c_somethingWrong);
+        }
+    }
+
+    // Ошибка продолжения не должна останавливать очередь: она только записывается в журнал.
+    void proceed(const Then & then) noexcept {
+        try {
+            then();
+        } catch (const Basic::Failure & e) {
+            LOG_ERROR_TS(e);
+        } catch (const std::exception & e) {
+            LOG_ERROR_TS(e);
+        } catch (...) {
+            LOG_ERROR_TS(Basic::Wcs::c_somethingWrong);
+        }
+    }
+
+    // Выполняет операции очереди, пока они есть; опустевшая очередь удаляется.
+    void drainLane(const std::string & serialNumber) {
+        for (;;) {
+            Step step {};
+            {
+                std::scoped_lock lanesLock(s_lanesMutex);
+                auto & lane = s_lanes.at(serialNumber);
+                if (lane.m_steps.empty()) {
+                    s_lanes.erase(serialNumber);
+                    return;
+                }
+                step = std::move(lane.m_steps.front());
+                lane.m_steps.pop_front();
+                if (step.m_joint) {
+                    // Запросы, поступившие после начала обмена с устройством, к этому обмену уже не присоединяются.
+                    lane.m_pending.erase(step.m_key);
+                }
+            }
+
+            performMethod(step.m_method, *step.m_payload);
+
+            // Присоединиться к обмену можно было только до его начала, поэтому список уже не меняется.
+            if (step.m_joint) {
+                for (auto & follower : step.m_joint->m_followers) {
+                    follower.m_payload->m_result = step.m_payload->m_result;
+                    follower.m_payload->m_expiresAfter = step.m_payload->m_expiresAfter;
+                    follower.m_payload->m_status = step.m_payload->m_status;
+                    proceed(follower.m_then);
+                }
+            }
+            proceed(step.m_then);
+        }
+    }
+
+    // Ставит операцию в очередь ККМ или присоединяет её к ожидающему идентичному обмену. Вызывается
+    // под s_lanesMutex; возвращает true, если очередь свободна и вызывающему пора стать её владельцем.
+    [[nodiscard]]
+    bool enqueue(
+        Lane & lane, const std::string & serialNumber, const Operation key, const bool coalescible,
+        const Method method, std::shared_ptr<Payload> payload, Then then
+    ) {
+        if (coalescible) {
+            if (auto it = lane.m_pending.find(key); it != lane.m_pending.end()) {
+                LOG_DEBUG_TS(Wcs::c_coalesced, payload->m_requestId, Text::convert(serialNumber));
+                it->second->m_followers.push_back({ std::move(payload), std::move(then) });
+                return false;
+            }
+        }
+
+        std::shared_ptr<Joint> joint {};
+        if (coalescible) {
+            joint = std::make_shared<Joint>();
+            lane.m_pending.emplace(key, joint);
+        }
+        const auto requestId = payload->m_requestId;
+        lane.m_steps.push_back({ key, method, std::move(payload), std::move(then), std::move(joint) });
+
+        if (lane.m_owned) {
+            LOG_DEBUG_TS(Wcs::c_queued, requestId, Text::convert(serialNumber), lane.m_steps.size());
+            return false;
+        }
+        lane.m_owned = true;
+        return true;
+    }
+
+    // Выполняет операцию в очереди ККМ и вызывает then, когда результат записан в payload. Если очередь
+    // занята, операция ставится в неё и функция сразу возвращает управление.
+    void performInLane(
+        const Operation key, const bool coalescible, const Method method,
+        std::shared_ptr<Payload> payload, Then then
+    ) {
+        if (payload->m_serialNumber.empty()) {
+            performMethod(method, *payload);
+            return proceed(then);
+        }
+
+        const std::string serialNumber { payload->m_serialNumber };
+        bool owner;
+        {
+            std::scoped_lock lanesLock(s_lanesMutex);
+            owner = enqueue(
+                s_lanes[serialNumber], serialNumber, key, coalescible, method, std::move(payload), std::move(then)
+            );
+        }
+        if (owner) {
+            drainLane(serialNumber);
+        }
+    }
+
+    // То же, но только если у ККМ нет очереди: фоновая операция не встаёт перед запросами клиентов.
+    // Идентичные запросы клиентов, поступившие во время обмена, присоединяются к нему.
+    [[nodiscard]]
+    bool performIfIdle(const Operation key, const Method method, std::shared_ptr<Payload> payload, Then then) {
+        const std::string serialNumber { payload->m_serialNumber };
+        {
+            std::scoped_lock lanesLock(s_lanesMutex);
+            if (s_lanes.contains(serialNumber)) {
+                return false;
             }
+            const bool owner {
+                enqueue(s_lanes[serialNumber], serialNumber, key, true, method, std::move(payload), std::move(then))
+            };
+            assert(owner);
         }
+        drainLane(serialNumber);
+        return true;
+    }
+
+    // Выполняющийся запрос с ключом идемпотентности. Повтор, поступивший до того, как ответ попал
+    // в кэш, не открывает второй сеанс с устройством: он присоединяется к выполняющемуся запросу
+    // и завершается вместе с ним, не занимая потока в ожидании.
+    struct Flight {
+        std::mutex m_mutex {};
+        decltype(Http::Response::m_data) m_data { nullptr };
+        Http::Status m_status { Http::Status::Ok };
+        bool m_landed { false };
+        std::vector<Then> m_joiners {};
     };
 
+    static std::unordered_map<Cache::Key, std::shared_ptr<Flight>> s_flights {};
+    static std::mutex s_flightsMutex {};
+
+    // Регистрирует запрос как выполняющийся. Если запрос с тем же ключом уже выполняется,
+    // возвращает его и false.
+    [[nodiscard]]
+    /*inline*/ std::pair<std::shared_ptr<Flight>, bool> depart(const Cache::Key & key) {
+        std::scoped_lock flightsLock(s_flightsMutex);
+        auto & flight = s_flights[key];
+        if (flight) {
+            return { flight, false };
+        }
+        flight = std::make_shared<Flight>();
+        return { flight, true };
+    }
+
+    // Снимает запрос с учёта и передаёт ответ присоединившимся. Если ответ так и не был сформирован
+    // (выполнение прервано исключением), присоединившиеся получают ошибку, а не повторяют команду сами.
+    /*inline*/ void land(
+        const Cache::Key & key, const std::shared_ptr<Flight> & flight, const Http::Response & response
+    ) noexcept {
+        {
+            std::scoped_lock flightsLock(s_flightsMutex);
+            s_flights.erase(key);
+        }
+        std::vector<Then> joiners {};
+        {
+            std::scoped_lock flightLock(flight->m_mutex);
+            if (response.m_data.index() == 0) {
+                flight->m_status = Http::Status::InternalServerError;
+                flight->m_data.emplace<std::string>(Basic::Mbs::c_somethingWrong);
+            } else {
+                flight->m_status = response.m_status;
+                flight->m_data = response.m_data;
+            }
+            flight->m_landed = true;
+            joiners.swap(flight->m_joiners);
+        }
+        for (const auto & joiner : joiners) {
+            proceed(joiner);
+        }
+    }
+
+    // Присоединяет запрос к выполняющемуся; done вызывается, когда ответ скопирован в запрос.
+    /*inline*/ void join(const std::shared_ptr<Flight> & flight, Http::Request & request, Then done) {
+        // После посадки ответ не меняется, поэтому читается без блокировки.
+        auto receive = [flight, & request, done = std::move(done)] {
+            request.m_response.m_status = flight->m_status;
+            request.m_response.m_data = flight->m_data;
+            done();
+        };
+        {
+            std::scoped_lock flightLock(flight->m_mutex);
+            if (!flight->m_landed) {
+                LOG_DEBUG_TS(Wcs::c_joinedFlight, request.m_id);
+                flight->m_joiners.emplace_back(std::move(receive));
+                return;
+            }
+        }
+        receive();
+    }
+
+    [[nodiscard]]
+    /*inline*/ bool loadCached(const Cache::Key & key, Http::Request & request) {
+        if (auto cacheEntry = Cache::load(key); cacheEntry) {
+            request.m_response.m_status = cacheEntry->m_status;
+            request.m_response.m_data = cacheEntry->m_data;
+            LOG_DEBUG_TS(Cache::Wcs::c_fromCache, request.m_id);
+            return true;
+        }
+        return false;
+    }
+
     [[maybe_unused]]
     /*inline*/ std::shared_ptr<KnownConnParams> resolveConnParams(Payload & payload) {
         if (payload.m_serialNumber.empty()) {
@@ -105,10 +386,8 @@ namespace Server::KkmOp {
     [[maybe_unused]]
     void callMethod(UndetailedMethod<R> method, Payload & payload) {
         if (const auto connParams = resolveConnParams(payload); connParams) {
-            callMethod(
-                Device { *connParams, std::format(Wcs::c_requestPrefix, payload.m_requestId) },
-                method, payload.m_result
-            );
+            auto kkm = Pool::acquire(*connParams, payload.prefix());
+            callMethod(*kkm, method, payload.m_result);
         }
     }
 
@@ -116,10 +395,8 @@ namespace Server::KkmOp {
     [[maybe_unused]]
     void callMethod(DetailedMethod<R, D> method, Payload & payload) {
         if (const auto connParams = resolveConnParams(payload); connParams) {
-            callMethod(
-                Device { *connParams, std::format(Wcs::c_requestPrefix, payload.m_requestId) },
-                method, payload.m_details, payload.m_result
-            );
+            auto kkm = Pool::acquire(*connParams, payload.prefix());
+            callMethod(*kkm, method, payload.m_details, payload.m_result);
         }
     }
 
@@ -134,8 +411,10 @@ namespace Server::KkmOp {
             return payload.fail(Http::Status::BadRequest, KKM_FMT(Kkm::Mbs::c_requiresProperty, "connParams"));
         }
 
+        // Порт может быть занят соединением из пула.
+        Pool::clear();
         NewConnParams connParams { connString };
-        Device kkm { connParams, std::format(Wcs::c_requestPrefix, payload.m_requestId) };
+        Device kkm { connParams, payload.prefix() };
         std::wstring serialNumber { kkm.serialNumber() };
         LOG_DEBUG_TS(Wcs::c_getKkmInfo, payload.m_requestId, serialNumber);
         connParams.save(serialNumber);
@@ -159,6 +438,7 @@ namespace Server::KkmOp {
     void resetRegistry(Payload & payload) {
         std::scoped_lock registryLock(s_registryMutex);
         s_connParamsRegistry.clear();
+        Pool::clear();
         if (!s_connParamsRegistry.empty()) {
             payload.fail(Http::Status::InternalServerError, Mbs::c_cantClearRegistry);
         }
@@ -177,9 +457,10 @@ namespace Server::KkmOp {
             return payload.fail(Http::Status::BadRequest, Server::Mbs::c_badRequest);
         }
         if (const auto connParams = resolveConnParams(payload); connParams) {
+            auto kkm = Pool::acquire(*connParams, payload.prefix());
             collectDataFromMethods(
                 payload.m_result,
-                Device { *connParams, std::format(Wcs::c_requestPrefix, payload.m_requestId) },
+                *kkm,
                 &Device::getStatus,
                 &Device::getShiftState,
                 &Device::getReceiptState,
@@ -199,9 +480,10 @@ namespace Server::KkmOp {
             return payload.fail(Http::Status::BadRequest, Server::Mbs::c_badRequest);
         }
         if (const auto connParams = resolveConnParams(payload); connParams) {
+            auto kkm = Pool::acquire(*connParams, payload.prefix());
             collectDataFromMethods(
                 payload.m_result,
-                Device { *connParams, std::format(Wcs::c_requestPrefix, payload.m_requestId) },
+                *kkm,
                 &Device::getStatus,
                 &Device::getShiftState,
                 &Device::getReceiptState,
@@ -296,159 +578,411 @@ namespace Server::KkmOp {
         payload.m_expiresAfter = c_reportCacheLifeTime;
     }
 
-    static const std::unordered_map<std::string, void (*)(Payload &)> s_handlers {
-        { "get/kkm/base-status", baseStatus },
-        { "get/kkm/status", status },
-        { "get/kkm/full-status", fullStatus },
-        { "post/kkm/learn", learn },
-        { "post/kkm/reset-registry", resetRegistry },
-        { "post/kkm/print-demo", printDemo },
-        { "post/kkm/print-non-fiscal-doc", printNonFiscalDocument },
-        { "post/kkm/print-info", printInfo },
-        { "post/kkm/print-fn-registrations", printFnRegistrations },
-        { "post/kkm/print-ofd-exchange-status", printOfdExchangeStatus },
-        { "post/kkm/print-ofd-test", printOfdTest },
-        { "post/kkm/print-close-shift-reports", printCloseShiftReports },
-        { "post/kkm/print-last-document", printLastDocument },
-        { "get/kkm/cash-stat", cashStat },
-        { "post/kkm/cash-in", cashIn },
-        { "post/kkm/cash-out", cashOut },
-        { "post/kkm/sell", sell },
-        { "post/kkm/sell-return", sellReturn },
-        { "post/kkm/report-x", reportX },
-        { "post/kkm/report-z", closeShift },
-        { "post/kkm/close-shift", closeShift },
-        { "post/kkm/reset-state", resetState }
+    // Порядок совпадает с перечислением Kkm::Operation.
+    static constexpr std::array<Method, c_operationCount> c_methods {
+        baseStatus,
+        status,
+        fullStatus,
+        learn,
+        resetRegistry,
+        printDemo,
+        printNonFiscalDocument,
+        printInfo,
+        printFnRegistrations,
+        printOfdExchangeStatus,
+        printOfdTest,
+        printCloseShiftReports,
+        printLastDocument,
+        cashStat,
+        cashIn,
+        cashOut,
+        sell,
+        sellReturn,
+        reportX,
+        closeShift,
+        resetState
     };
 
-    bool Handler::asyncReady() const noexcept {
-        return true;
+    // Снимок ответа на запрос состояния ККМ. Снимок появляется после первого такого запроса к ККМ и
+    // затем обновляется фоновым опросом, пока его читают.
+    struct Snapshot {
+        std::shared_ptr<Http::SerializedResponse> m_data {};
+        DateTime::Point m_takenAt {};
+        DateTime::Point m_readAt {};
+    };
+
+    using SnapshotKey = std::pair<std::string, Operation>;
+
+    static std::map<SnapshotKey, Snapshot> s_snapshots {};
+    static std::mutex s_snapshotsMutex {};
+
+    [[nodiscard]]
+    /*inline*/ bool polled(const Operation operation) noexcept {
+        return s_statusPollInterval > 0 && (operation == Operation::Status || operation == Operation::FullStatus);
     }
 
-    void Handler::operator()(Http::Request & request) const noexcept try {
-        assert(request.m_response.m_status == Http::Status::Ok);
+    [[nodiscard]]
+    /*inline*/ DateTime::Offset pollInterval(const int64_t count = 1) noexcept {
+        return DateTime::Offset { s_statusPollInterval * count };
+    }
 
-        std::string idempotencyKey {};
+    // Сериализует результат и сохраняет его как снимок; возвращает сериализованный ответ.
+    /*inline*/ std::shared_ptr<Http::SerializedResponse> keepSnapshot(
+        const std::string & serialNumber, const Operation operation, Http::ProtoResponse & response
+    ) {
+        auto data = Http::SerializedResponse::from(
+            response, Http::Status::Ok, static_cast<size_t>(s_compressionThreshold)
+        );
+        const auto now = DateTime::Clock::now();
+        std::scoped_lock snapshotsLock(s_snapshotsMutex);
+        auto [it, created] = s_snapshots.try_emplace({ serialNumber, operation });
+        it->second.m_data = data;
+        it->second.m_takenAt = now;
+        if (created) {
+            it->second.m_readAt = now;
+        }
+        return data;
+    }
 
+    // Снимок старше нескольких интервалов опроса не отдаётся: опрос, видимо, не проходит.
+    [[nodiscard]]
+    /*inline*/ std::shared_ptr<Http::ProtoResponse> readSnapshot(
+        const std::string & serialNumber, const Operation operation, const Payload::Id requestId
+    ) {
+        const auto now = DateTime::Clock::now();
+        std::shared_ptr<Http::SerializedResponse> data {};
+        DateTime::Offset age {};
         {
-            auto it = request.m_header.find("x-idempotency-key");
-            if (it != request.m_header.end()) {
-                idempotencyKey.assign(it->second);
+            std::scoped_lock snapshotsLock(s_snapshotsMutex);
+            const auto it = s_snapshots.find({ serialNumber, operation });
+            if (it == s_snapshots.end()) {
+                return nullptr;
             }
+            it->second.m_readAt = now;
+            age = std::chrono::duration_cast<DateTime::Offset>(now - it->second.m_takenAt);
+            if (age > pollInterval(c_snapshotStaleness)) {
+                return nullptr;
+            }
+            data = it->second.m_data;
         }
+        LOG_DEBUG_TS(Wcs::c_fromSnapshot, requestId, Text::convert(serialNumber), age.count());
+        return std::make_shared<Http::AgedResponse>(std::move(data), age);
+    }
 
-        if (request.m_method == Http::Method::Post) {
-            if (idempotencyKey.empty()) {
-                return fail(request, Http::Status::BadRequest, Server::Mbs::c_invalidXIdempotencyKey);
-            }
-            auto it = request.m_header.find("content-type");
-            if (it != request.m_header.end()) {
-                bool typeOk { false };
-                bool charsetOk { true };
-                std::vector<std::string> chunks;
-                Text::splitTo(chunks, it->second, " ;");
-                for (auto & chunk: chunks) {
-                    Text::trim(chunk);
-                    if (chunk == "application/json") {
-                        typeOk = true;
-                    } else {
-                        std::string subHeader, subValue;
-                        Text::splitVariable(chunk, subHeader, subValue, true, true);
-                        if (subHeader == "charset" && subValue != "utf-8" && subValue != "utf8") {
-                            charsetOk = false;
-                        }
-                    }
+    // Номера опросов: ошибки опроса отличаются друг от друга и от ошибок запросов (префикс "Опрос").
+    // Опрос выполняется только в потоке опроса, поэтому синхронизация не нужна.
+    static Payload::Id s_pollSequence { 0 };
+
+    // Обновляет снимки, которые пора обновить, и забывает давно не запрашивавшиеся.
+    void poll() {
+        const auto now = DateTime::Clock::now();
+        std::vector<SnapshotKey> due {};
+        {
+            std::scoped_lock snapshotsLock(s_snapshotsMutex);
+            for (auto it = s_snapshots.begin(); it != s_snapshots.end();) {
+                if (now - it->second.m_readAt > pollInterval(c_snapshotIdleness)) {
+                    LOG_DEBUG_TS(Wcs::c_pollStopped, Text::convert(it->first.first));
+                    it = s_snapshots.erase(it);
+                    continue;
                 }
-                if (!typeOk || !charsetOk) {
-                    return fail(request, Http::Status::BadRequest, Server::Mbs::c_invalidContentType);
+                if (now - it->second.m_takenAt >= pollInterval()) {
+                    due.push_back(it->first);
                 }
+                ++it;
             }
-        } else if (request.m_method != Http::Method::Get) {
-            return fail(request, Http::Status::MethodNotAllowed, Server::Mbs::c_methodNotAllowed);
-        }
-
-        Cache::maintain();
-        Cache::Key cacheKey;
-
-        if (!idempotencyKey.empty()) {
-            cacheKey.assign("kkm::::");
-            cacheKey.append(request.m_remote.to_string());
-            cacheKey.append("::::");
-            cacheKey.append(idempotencyKey);
         }
 
-        if (!cacheKey.empty()) {
-            if (auto cacheEntry = Cache::load(cacheKey); cacheEntry) {
-                request.m_response.m_status = cacheEntry->m_status;
-                request.m_response.m_data = cacheEntry->m_data;
-                LOG_DEBUG_TS(Cache::Wcs::c_fromCache, request.m_id);
-                return;
+        for (auto & [serialNumber, operation] : due) {
+            const auto pollId = ++s_pollSequence;
+            auto payload
+                = std::make_shared<Payload>(
+                    std::string { serialNumber }, Nln::Json(Nln::EmptyJsonObject), pollId, 0s, true
+                );
+            LOG_DEBUG_TS(Wcs::c_pollStarted, pollId, Text::convert(serialNumber));
+            const bool performed = performIfIdle(
+                operation, c_methods[static_cast<size_t>(operation)], payload,
+                [payload, operation = operation] {
+                    // Ошибку уже записал Payload::fail; прежний снимок устареет и перестанет отдаваться.
+                    if (payload->m_status == Http::Status::Ok && payload->m_result.has_value()) {
+                        Http::JsonResponse response { std::move(payload->m_result.value()) };
+                        keepSnapshot(payload->m_serialNumber, operation, response);
+                    }
+                }
+            );
+            // Занятое устройство опрашивается на следующем шаге опроса.
+            if (!performed) {
+                LOG_DEBUG_TS(Wcs::c_pollPostponed, Text::convert(serialNumber));
             }
         }
+    }
 
-        std::string handlerKey, serialNumber;
+    // Опрос идёт в собственном потоке: обмен с устройством длится секунды и не должен занимать
+    // поток пула обработчиков.
+    static std::thread s_poller {};
+    static std::mutex s_pollerMutex {};
+    static std::condition_variable s_pollerCondition {};
+    static bool s_pollerStopping { false };
 
-        if (request.m_hint.size() == 4) {
-            Text::concatTo(handlerKey, request.m_hint[0], "/", request.m_hint[1], "/", request.m_hint[3]);
-            serialNumber.assign(request.m_hint[2]);
-        } else if (request.m_hint.size() == 3) {
-            Text::joinTo(handlerKey, request.m_hint, "/");
-        } else {
-            return fail(request, Http::Status::NotFound, Server::Mbs::c_notFound);
+    void startPolling() {
+        if (s_statusPollInterval <= 0 || s_poller.joinable()) {
+            return;
         }
-
-        auto handler = s_handlers.find(handlerKey);
-        if (handler == s_handlers.end()) {
-            return fail(request, Http::Status::NotFound, Server::Mbs::c_notFound);
+        {
+            std::scoped_lock pollerLock(s_pollerMutex);
+            s_pollerStopping = false;
         }
-
-        Nln::Json details(Nln::EmptyJsonObject);
-        assert(details.is_object());
-        if (request.m_method == Http::Method::Post && !request.m_body.empty()) {
-            details = Nln::Json::parse(request.m_body);
-            if (!details.is_object()) {
-                return fail(request, Http::Status::BadRequest, Server::Mbs::c_badRequest);
+        s_poller = std::thread(
+            [] {
+                std::unique_lock pollerLock(s_pollerMutex);
+                while (!s_pollerCondition.wait_for(pollerLock, c_pollTick, [] { return s_pollerStopping; })) {
+                    pollerLock.unlock();
+                    try {
+                        poll();
+                    } catch (const Basic::Failure & e) {
+                        LOG_ERROR_TS(e);
+                    } catch (const std::exception & e) {
+                        LOG_ERROR_TS(e);
+                    } catch (...) {
+                        LOG_ERROR_TS(Basic::Wcs::c_somethingWrong);
+                    }
+                    pollerLock.lock();
+                }
             }
-        }
-
-        Payload payload {
-            std::move(serialNumber), std::move(details), request.m_id,
-            request.m_method == Http::Method::Get ? c_reportCacheLifeTime : c_receiptCacheLifeTime
-        };
+        );
+    }
 
-        handler->second(payload);
+    void stopPolling() noexcept {
+        if (!s_poller.joinable()) {
+            return;
+        }
+        {
+            std::scoped_lock pollerLock(s_pollerMutex);
+            s_pollerStopping = true;
+        }
+        s_pollerCondition.notify_all();
+        s_poller.join();
+    }
 
+    // Сохраняет результат операции в кэш и формирует ответ. Исключение превращается в ответ с ошибкой.
+    void conclude(
+        Http::Request & request, const Cache::Key & cacheKey, Payload & payload,
+        const Operation operation, const bool snapshotted
+    ) noexcept try {
         assert(!payload.m_result.has_value() || payload.m_result.value().is_object());
         assert(request.m_response.m_status == Http::Status::Ok);
 
-        if (!payload.m_result.has_value() && payload.m_status == Http::Status::Ok) {
-            if (!cacheKey.empty()) {
-                Cache::store(
+        // Ответ на фискальную команду защищает от её повторного выполнения: он вытесняется из кэша
+        // в последнюю очередь и сохраняется в журнал, чтобы пережить перезапуск службы.
+        const bool fiscal { request.m_method == Http::Method::Post };
+        auto remember = [&cacheKey, &payload, fiscal] (const Http::Status status, Http::ProtoResponse & response) {
+            const auto expiredAt = Cache::expiresAfter(payload.m_expiresAfter);
+            const auto priority = fiscal ? Cache::Priority::Durable : Cache::Priority::Regular;
+            auto data = Cache::store(cacheKey, expiredAt, status, response, priority);
+            if (fiscal) {
+                Journal::append(
                     cacheKey,
-                    Cache::expiresAfter(payload.m_expiresAfter),
-                    Http::Status::Ok,
-                    Http::ConstantResponse::s_okResponse
+                    {
+                        .m_data = data,
+                        .m_cachedAt = DateTime::Clock::now(),
+                        .m_expiredAt = expiredAt,
+                        .m_status = status,
+                        .m_priority = priority
+                    }
                 );
             }
+            return data;
+        };
+
+        if (!payload.m_result.has_value() && payload.m_status == Http::Status::Ok) {
+            if (!cacheKey.empty()) {
+                remember(Http::Status::Ok, *Http::ConstantResponse::s_okResponse);
+            }
             if (request.m_response.m_status == Http::Status::Ok) {
                 request.m_response.m_data = Http::ConstantResponse::s_okResponse;
             }
         } else {
-            auto response = std::make_shared<Http::JsonResponse>(std::move(payload.m_result));
+            std::shared_ptr<Http::ProtoResponse> response
+                = std::make_shared<Http::JsonResponse>(std::move(payload.m_result));
+            if (snapshotted && payload.m_status == Http::Status::Ok) {
+                response = keepSnapshot(payload.m_serialNumber, operation, *response);
+            }
             if (!cacheKey.empty()) {
-                Cache::store(cacheKey, Cache::expiresAfter(payload.m_expiresAfter), payload.m_status, response);
+                response = remember(payload.m_status, *response);
             }
             if (request.m_response.m_status == Http::Status::Ok) {
                 request.m_response.m_status = payload.m_status;
                 request.m_response.m_data = std::move(response);
             }
         }
-
     } catch (const Basic::Failure & e) {
-        fail(request, Http::Status::InternalServerError, Text::convert(e.what()), e.where());
+        ProtoHandler::fail(request, Http::Status::InternalServerError, Text::convert(e.what()), e.where());
     } catch (const std::exception & e) {
-        fail(request, Http::Status::InternalServerError, e.what());
+        ProtoHandler::fail(request, Http::Status::InternalServerError, e.what());
     } catch (...) {
-        fail(request, Http::Status::InternalServerError, Basic::Mbs::c_somethingWrong);
+        ProtoHandler::fail(request, Http::Status::InternalServerError, Basic::Mbs::c_somethingWrong);
+    }
+
+    // Выполняет запрос на устройстве и вызывает done, когда ответ сформирован. Исключение превращается
+    // в ответ с ошибкой, поэтому к вызову done ответ запроса заполнен всегда.
+    void perform(Http::Request & request, const Cache::Key & cacheKey, Then done) noexcept {
+        // Если операция не передана в очередь ККМ, запрос завершается здесь.
+        Deferred::Exec completion([& done] { proceed(done); });
+
+        try {
+            std::string_view operationName {};
+            std::string serialNumber {};
+
+            if (request.m_hint.size() == 4) {
+                operationName = request.m_hint[3];
+                serialNumber.assign(request.m_hint[2]);
+            } else if (request.m_hint.size() == 3) {
+                operationName = request.m_hint[2];
+            } else {
+                return ProtoHandler::fail(request, Http::Status::NotFound, Server::Mbs::c_notFound);
+            }
+
+            // Запросы доступны только методом GET, команды - только методом POST.
+            const auto found = findOperation(operationName);
+            if (!found || (found->m_kind == OperationKind::Query) != (request.m_method == Http::Method::Get)) {
+                return ProtoHandler::fail(request, Http::Status::NotFound, Server::Mbs::c_notFound);
+            }
+            const auto operation = found->m_operation;
+            const bool snapshotted { polled(operation) };
+
+            // Параметр fresh=1 требует обратиться к устройству; полученный ответ обновит снимок.
+            if (snapshotted && !serialNumber.empty() && request.parameter("fresh") != "1") {
+                if (auto response = readSnapshot(serialNumber, operation, request.m_id); response) {
+                    request.m_response.m_data = std::move(response);
+                    return;
+                }
+            }
+
+            Nln::Json details(Nln::EmptyJsonObject);
+            assert(details.is_object());
+            if (request.m_method == Http::Method::Post && !request.m_body.empty()) {
+                details = Nln::Json::parse(request.m_body);
+                if (!details.is_object()) {
+                    return ProtoHandler::fail(request, Http::Status::BadRequest, Server::Mbs::c_badRequest);
+                }
+            }
+
+            auto payload = std::make_shared<Payload>(
+                std::move(serialNumber), std::move(details), request.m_id,
+                request.m_method == Http::Method::Get ? c_reportCacheLifeTime : c_receiptCacheLifeTime
+            );
+
+            completion.cancel();
+            performInLane(
+                operation, request.m_method == Http::Method::Get, c_methods[static_cast<size_t>(operation)], payload,
+                [& request, cacheKey, payload, operation, snapshotted, done = std::move(done)] {
+                    conclude(request, cacheKey, *payload, operation, snapshotted);
+                    done();
+                }
+            );
+        } catch (const Basic::Failure & e) {
+            ProtoHandler::fail(request, Http::Status::InternalServerError, Text::convert(e.what()), e.where());
+        } catch (const std::exception & e) {
+            ProtoHandler::fail(request, Http::Status::InternalServerError, e.what());
+        } catch (...) {
+            ProtoHandler::fail(request, Http::Status::InternalServerError, Basic::Mbs::c_somethingWrong);
+        }
+    }
+
+    bool Handler::asyncReady() const noexcept {
+        return true;
+    }
+
+    // Синхронный вызов ждёт завершения запроса в текущем потоке.
+    void Handler::operator()(Http::Request & request) const noexcept {
+        std::binary_semaphore completed { 0 };
+        (*this)(request, [& completed] { completed.release(); });
+        completed.acquire();
+    }
+
+    void Handler::operator()(Http::Request & request, Completion done) const noexcept {
+        // Если завершение не передано дальше (в очередь ККМ или выполняющемуся запросу), запрос завершается здесь.
+        Deferred::Exec completion([& done] { proceed(done); });
+
+        try {
+            assert(request.m_response.m_status == Http::Status::Ok);
+
+            std::string idempotencyKey { request.m_header[Http::Field::XIdempotencyKey] };
+
+            if (request.m_method == Http::Method::Post) {
+                if (idempotencyKey.empty()) {
+                    return fail(request, Http::Status::BadRequest, Server::Mbs::c_invalidXIdempotencyKey);
+                }
+                if (request.m_header.has(Http::Field::ContentType)) {
+                    bool typeOk { false };
+                    bool charsetOk { true };
+                    std::vector<std::string> chunks;
+                    Text::splitTo(chunks, request.m_header[Http::Field::ContentType], " ;");
+                    for (auto & chunk: chunks) {
+                        Text::trim(chunk);
+                        if (chunk == "application/json") {
+                            typeOk = true;
+                        } else {
+                            std::string subHeader, subValue;
+                            Text::splitVariable(chunk, subHeader, subValue, true, true);
+                            if (subHeader == "charset" && subValue != "utf-8" && subValue != "utf8") {
+                                charsetOk = false;
+                            }
+                        }
+                    }
+                    if (!typeOk || !charsetOk) {
+                        return fail(request, Http::Status::BadRequest, Server::Mbs::c_invalidContentType);
+                    }
+                }
+            } else if (request.m_method != Http::Method::Get) {
+                return fail(request, Http::Status::MethodNotAllowed, Server::Mbs::c_methodNotAllowed);
+            }
+
+            Cache::Key cacheKey;
+
+            if (!idempotencyKey.empty()) {
+                cacheKey.assign("kkm::::");
+                cacheKey.append(request.m_remote.to_string());
+                cacheKey.append("::::");
+                cacheKey.append(idempotencyKey);
+            }
+
+            if (cacheKey.empty()) {
+                completion.cancel();
+                return perform(request, cacheKey, std::move(done));
+            }
+            if (loadCached(cacheKey, request)) {
+                return;
+            }
+
+            // Ведущий запрос сначала сохраняет ответ в кэш и только потом снимается с учёта, поэтому
+            // повтор либо находит ответ в кэше, либо присоединяется к выполняющемуся запросу.
+            std::shared_ptr<Flight> flight {};
+            bool leading;
+            std::tie(flight, leading) = depart(cacheKey);
+            if (!leading) {
+                completion.cancel();
+                return join(flight, request, std::move(done));
+            }
+
+            // Дальше запрос завершается только вместе с посадкой, в том числе при исключении:
+            // присоединившиеся получат тот же ответ, что и ведущий, даже если это ошибка.
+            done = [cacheKey, flight, & request, done = std::move(done)] {
+                land(cacheKey, flight, request.m_response);
+                done();
+            };
+
+            // Прежний ведущий мог сохранить ответ в кэш и сняться с учёта уже после проверки кэша выше.
+            if (loadCached(cacheKey, request)) {
+                return;
+            }
+            completion.cancel();
+            perform(request, cacheKey, std::move(done));
+        } catch (const Basic::Failure & e) {
+            fail(request, Http::Status::InternalServerError, Text::convert(e.what()), e.where());
+        } catch (const std::exception & e) {
+            fail(request, Http::Status::InternalServerError, e.what());
+        } catch (...) {
+            fail(request, Http::Status::InternalServerError, Basic::Mbs::c_somethingWrong);
+        }
     }
 }
@@ -18,5 +18,11 @@ namespace Server::KkmOp {
 
         [[nodiscard]] bool asyncReady() const noexcept override;
         void operator()(Http::Request &) const noexcept override;
+        void operator()(Http::Request &, Completion) const noexcept override;
     };
+
+    // Фоновый опрос состояния ККМ (server.statusPollInterval) в отдельном потоке: обновляет снимки,
+    // которые пора обновить.
+    void startPolling();
+    void stopPolling() noexcept;
 }
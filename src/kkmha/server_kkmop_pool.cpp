@@ -0,0 +1,143 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#include "server_kkmop_pool.h"
+#include "server_variables.h"
+#include "server_kkmop_strings.h"
+#include <lib/datetime.h>
+#include <log/write.h>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+namespace Server::KkmOp::Pool {
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::unique_ptr<Kkm::Device> m_device;
+        Clock::time_point m_releasedAt;
+    };
+
+    static std::unordered_map<std::wstring, Entry> s_pool {};
+    static std::mutex s_poolMutex {};
+    static std::atomic<uint64_t> s_hits { 0 };
+    static std::atomic<uint64_t> s_misses { 0 };
+    static std::atomic<uint64_t> s_evictions { 0 };
+
+    [[nodiscard]]
+    inline bool expired(const Entry & entry, const Clock::time_point now) {
+        return now - entry.m_releasedAt > std::chrono::seconds(s_deviceIdleTimeout);
+    }
+
+    void giveBack(std::wstring && serialNumber, std::unique_ptr<Kkm::Device> && device) {
+        device->release();
+        std::unique_ptr<Kkm::Device> replaced {};
+
+        {
+            std::scoped_lock poolLock(s_poolMutex);
+            auto & entry = s_pool[std::move(serialNumber)];
+            replaced.swap(entry.m_device);
+            entry.m_device = std::move(device);
+            entry.m_releasedAt = Clock::now();
+        }
+
+        if (replaced) {
+            ++s_evictions;
+        }
+    }
+
+    Lease acquire(const Kkm::KnownConnParams & connParams, const std::wstring_view logPrefix) {
+        if (s_deviceIdleTimeout <= 0) {
+            ++s_misses;
+            return { std::make_unique<Kkm::Device>(connParams, logPrefix), false };
+        }
+
+        std::unique_ptr<Kkm::Device> device {};
+
+        {
+            std::scoped_lock poolLock(s_poolMutex);
+            if (auto it = s_pool.find(connParams.serialNumber()); it != s_pool.end()) {
+                if (!expired(it->second, Clock::now())) {
+                    device = std::move(it->second.m_device);
+                }
+                s_pool.erase(it);
+            }
+        }
+
+        if (device) {
+            device->logPrefix(logPrefix);
+            if (device->alive()) {
+                ++s_hits;
+                LOG_DEBUG_TS(Wcs::c_poolHit, logPrefix, connParams.serialNumber(), s_hits.load(), s_misses.load());
+                return { std::move(device), true };
+            }
+            ++s_evictions;
+            device.reset();
+            LOG_DEBUG_TS(Wcs::c_poolStale, logPrefix, connParams.serialNumber());
+        }
+
+        ++s_misses;
+        return { std::make_unique<Kkm::Device>(connParams, logPrefix), true };
+    }
+
+    void evict(const std::wstring & serialNumber) {
+        std::unique_ptr<Kkm::Device> device {};
+
+        {
+            std::scoped_lock poolLock(s_poolMutex);
+            if (auto it = s_pool.find(serialNumber); it != s_pool.end()) {
+                device = std::move(it->second.m_device);
+                s_pool.erase(it);
+            }
+        }
+
+        if (device) {
+            ++s_evictions;
+        }
+    }
+
+    void clear() {
+        std::unordered_map<std::wstring, Entry> pool {};
+
+        {
+            std::scoped_lock poolLock(s_poolMutex);
+            pool.swap(s_pool);
+        }
+
+        s_evictions += pool.size();
+    }
+
+    void maintain() {
+        std::vector<std::unique_ptr<Kkm::Device>> expiredDevices {};
+
+        {
+            std::scoped_lock poolLock(s_poolMutex);
+            const auto now = Clock::now();
+            for (auto it = s_pool.begin(); it != s_pool.end();) {
+                if (expired(it->second, now)) {
+                    expiredDevices.emplace_back(std::move(it->second.m_device));
+                    it = s_pool.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        if (!expiredDevices.empty()) {
+            s_evictions += expiredDevices.size();
+            LOG_DEBUG_TS(Wcs::c_poolMaintain, expiredDevices.size());
+        }
+    }
+
+    Stats stats() {
+        std::scoped_lock poolLock(s_poolMutex);
+        return {
+            .m_hits = s_hits.load(),
+            .m_misses = s_misses.load(),
+            .m_evictions = s_evictions.load(),
+            .m_idle = static_cast<int64_t>(s_pool.size())
+        };
+    }
+}
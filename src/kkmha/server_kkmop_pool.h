@@ -0,0 +1,64 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#pragma once
+
+#include <kkm/device.h>
+#include <cassert>
+#include <exception>
+#include <utility>
+#include <memory>
+#include <string>
+
+namespace Server::KkmOp::Pool {
+    struct Stats {
+        uint64_t m_hits;
+        uint64_t m_misses;
+        uint64_t m_evictions;
+        int64_t m_idle;
+    };
+
+    void giveBack(std::wstring &&, std::unique_ptr<Kkm::Device> &&);
+
+    class Lease {
+        std::unique_ptr<Kkm::Device> m_device;
+        std::wstring m_serialNumber;
+        int m_exceptions;
+        bool m_reusable;
+
+    public:
+        Lease() = delete;
+        Lease(const Lease &) = delete;
+
+        Lease(Lease && other) noexcept
+        : m_device(std::move(other.m_device)), m_serialNumber(std::move(other.m_serialNumber)),
+          m_exceptions(other.m_exceptions), m_reusable(other.m_reusable) {}
+
+        Lease(std::unique_ptr<Kkm::Device> && device, const bool reusable)
+        : m_device(std::move(device)), m_serialNumber(m_device->serialNumber()),
+          m_exceptions(std::uncaught_exceptions()), m_reusable(reusable) {
+            assert(m_device);
+        }
+
+        ~Lease() {
+            // Если устройство освобождается при раскрутке стека, его состояние неизвестно - закрываем соединение.
+            if (m_device && m_reusable && std::uncaught_exceptions() <= m_exceptions) {
+                try {
+                    giveBack(std::move(m_serialNumber), std::move(m_device));
+                } catch (...) {}
+            }
+        }
+
+        Lease & operator=(const Lease &) = delete;
+        Lease & operator=(Lease &&) = delete;
+
+        [[nodiscard]] Kkm::Device & operator*() const noexcept { return *m_device; }
+        [[nodiscard]] Kkm::Device * operator->() const noexcept { return m_device.get(); }
+    };
+
+    [[nodiscard]] Lease acquire(const Kkm::KnownConnParams &, std::wstring_view);
+    void evict(const std::wstring &);
+    void clear();
+    void maintain();
+    [[nodiscard]] Stats stats();
+}
@@ -10,15 +10,28 @@ namespace Server::KkmOp {
         using Csv = const std::wstring_view;
 
         constexpr Csv c_requestPrefix { L"Запрос [{:04x}]: " };
+        constexpr Csv c_pollPrefix { L"Опрос [{:04x}]: " };
         constexpr Csv c_selectKkm { L"Запрос [{:04x}]: Выбрана ККМ [{}] (параметры подключения: {})" };
         constexpr Csv c_getKkmInfo { L"Запрос [{:04x}]: ККМ [{}]: Получение информации об устройстве" };
         constexpr Csv c_connParamsSaved { L"Запрос [{:04x}]: Параметры подключения ККМ [{}] успешно сохранены" };
+        constexpr Csv c_queued { L"Запрос [{:04x}]: ККМ [{}]: Ожидание в очереди устройства (впереди: {})" };
+        constexpr Csv c_poolHit { L"{}ККМ [{}]: Соединение взято из пула (попаданий: {}, промахов: {})" };
+        constexpr Csv c_poolStale { L"{}ККМ [{}]: Соединение из пула неработоспособно, переподключаемся" };
+        constexpr Csv c_poolMaintain { L"Пул соединений с ККМ: закрыто простаивающих соединений: {}" };
+        constexpr Csv c_coalesced { L"Запрос [{:04x}]: ККМ [{}]: Объединён с ожидающим идентичным запросом" };
+        constexpr Csv c_fromSnapshot { L"Запрос [{:04x}]: Ответ из снимка состояния ККМ [{}] (возраст: {} с)" };
+        constexpr Csv c_pollStarted { L"Опрос [{:04x}]: ККМ [{}]: Запрос состояния" };
+        constexpr Csv c_pollPostponed { L"ККМ [{}]: Опрос состояния отложен, устройство занято" };
+        constexpr Csv c_pollStopped { L"ККМ [{}]: Опрос состояния прекращён, снимок давно не запрашивался" };
+        constexpr Csv c_joinedFlight { L"Запрос [{:04x}]: Ожидание ответа на выполняющийся запрос с тем же ключом" };
     }
 
     namespace Mbs {
         using Csv = const std::string_view;
 
         constexpr Csv c_notFound { "Запрос [{:04x}]: ККМ [{}] не доступна" };
+        constexpr Csv c_pollPrefixedText { "Опрос [{:04x}]: {}" };
+        constexpr Csv c_pollPrefixedTextWithSource { "Опрос [{:04x}]: {} ({})" };
         constexpr Csv c_cantClearRegistry { "Не удалось очистить реестр параметров подключения" };
     }
 }
@@ -0,0 +1,124 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#include "server_metrics.h"
+#include "server_defaults.h"
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <map>
+#include <format>
+
+namespace Server::Metrics {
+    // Границы корзин гистограммы в микросекундах, последняя корзина (+Inf) подразумевается.
+    static constexpr std::array<int64_t, 12> c_bounds {
+        500, 1'000, 5'000, 10'000, 50'000, 100'000, 250'000, 500'000, 1'000'000, 5'000'000, 10'000'000, 30'000'000
+    };
+
+    static constexpr std::array<std::string_view, c_phaseCount> c_phaseNames {
+        "handshake", "read", "parse", "authorize", "handle", "write", "total"
+    };
+
+    struct Histogram {
+        std::array<std::atomic<uint64_t>, c_bounds.size() + 1> m_buckets {};
+        std::atomic<int64_t> m_sum { 0 }; // Микросекунды
+        std::atomic<uint64_t> m_count { 0 };
+
+        void observe(const Duration duration) noexcept {
+            const auto value = duration.count();
+            size_t i = 0;
+            while (i < c_bounds.size() && value > c_bounds[i]) {
+                ++i;
+            }
+            ++m_buckets[i];
+            m_sum += value;
+            ++m_count;
+        }
+    };
+
+    struct Route {
+        std::array<Histogram, c_phaseCount> m_phases {};
+    };
+
+    static std::map<std::string, std::unique_ptr<Route>, std::less<>> s_routes {};
+    static std::mutex s_routesMutex {};
+
+    [[nodiscard]]
+    Route & route(std::string_view name) {
+        std::scoped_lock routesLock(s_routesMutex);
+        auto it = s_routes.find(name);
+        if (it == s_routes.end()) {
+            if (s_routes.size() >= c_metricsRouteLimit) {
+                name = c_metricsOtherRoute;
+                it = s_routes.find(name);
+            }
+            if (it == s_routes.end()) {
+                it = s_routes.emplace(std::string(name), std::make_unique<Route>()).first;
+            }
+        }
+        return *it->second;
+    }
+
+    void record(const std::string_view name, const Timing & timing) {
+        auto & histograms = route(name).m_phases;
+        for (size_t i = 0; i < c_phaseCount; ++i) {
+            const auto phase = static_cast<Phase>(i);
+            if (timing.measured(phase)) {
+                histograms[i].observe(timing.elapsed(phase));
+            }
+        }
+    }
+
+    void appendHelp(
+        std::string & output,
+        const std::string_view name,
+        const std::string_view type,
+        const std::string_view help
+    ) {
+        std::format_to(std::back_inserter(output), "# HELP {} {}\n# TYPE {} {}\n", name, help, name, type);
+    }
+
+    void appendSample(
+        std::string & output,
+        const std::string_view name,
+        const std::string_view labels,
+        const double value
+    ) {
+        if (labels.empty()) {
+            std::format_to(std::back_inserter(output), "{} {}\n", name, value);
+        } else {
+            std::format_to(std::back_inserter(output), "{}{{{}}} {}\n", name, labels, value);
+        }
+    }
+
+    void render(std::string & output) {
+        constexpr std::string_view name { "kkmha_request_phase_seconds" };
+        appendHelp(output, name, "histogram", "Request processing time by route and phase.");
+
+        std::scoped_lock routesLock(s_routesMutex);
+        for (const auto & [routeName, route] : s_routes) {
+            for (size_t i = 0; i < c_phaseCount; ++i) {
+                const auto & histogram = route->m_phases[i];
+                const auto count = histogram.m_count.load();
+                if (!count) {
+                    continue;
+                }
+                const auto labels = std::format("route=\"{}\",phase=\"{}\"", routeName, c_phaseNames[i]);
+                uint64_t cumulative { 0 };
+                for (size_t j = 0; j < c_bounds.size(); ++j) {
+                    cumulative += histogram.m_buckets[j].load();
+                    std::format_to(
+                        std::back_inserter(output), "{}_bucket{{{},le=\"{}\"}} {}\n",
+                        name, labels, static_cast<double>(c_bounds[j]) / 1e6, cumulative
+                    );
+                }
+                std::format_to(std::back_inserter(output), "{}_bucket{{{},le=\"+Inf\"}} {}\n", name, labels, count);
+                std::format_to(
+                    std::back_inserter(output), "{}_sum{{{}}} {}\n",
+                    name, labels, static_cast<double>(histogram.m_sum.load()) / 1e6
+                );
+                std::format_to(std::back_inserter(output), "{}_count{{{}}} {}\n", name, labels, count);
+            }
+        }
+    }
+}
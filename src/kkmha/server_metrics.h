@@ -0,0 +1,70 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <chrono>
+#include <string>
+#include <string_view>
+
+namespace Server::Metrics {
+    using Clock = std::chrono::steady_clock;
+    using Duration = std::chrono::microseconds;
+
+    enum class Phase { Handshake, Read, Parse, Authorize, Handle, Write, Total };
+
+    constexpr size_t c_phaseCount { static_cast<size_t>(Phase::Total) + 1 };
+
+    // Замер фаз одного запроса. lap() относит время с предыдущей отметки к указанной фазе (фазы могут
+    // чередоваться, например чтение и разбор тела), restart() начинает замер заново, исключая простой.
+    class Timing {
+        Clock::time_point m_start;
+        Clock::time_point m_mark;
+        std::array<Duration, c_phaseCount> m_phases {};
+        uint32_t m_measured { 0 };
+
+    public:
+        Timing() : m_start { Clock::now() }, m_mark { m_start } {}
+        Timing(const Timing &) = default;
+        Timing(Timing &&) = default;
+        ~Timing() = default;
+
+        Timing & operator=(const Timing &) = default;
+        Timing & operator=(Timing &&) = default;
+
+        void restart() noexcept {
+            m_start = m_mark = Clock::now();
+        }
+
+        void lap(const Phase phase) noexcept {
+            const auto now = Clock::now();
+            const auto index = static_cast<size_t>(phase);
+            m_phases[index] += std::chrono::duration_cast<Duration>(now - m_mark);
+            m_measured |= 1u << index;
+            m_mark = now;
+        }
+
+        void finish() noexcept {
+            const auto index = static_cast<size_t>(Phase::Total);
+            m_phases[index] = std::chrono::duration_cast<Duration>(Clock::now() - m_start);
+            m_measured |= 1u << index;
+        }
+
+        [[nodiscard]]
+        bool measured(const Phase phase) const noexcept {
+            return m_measured & (1u << static_cast<size_t>(phase));
+        }
+
+        [[nodiscard]]
+        Duration elapsed(const Phase phase) const noexcept {
+            return m_phases[static_cast<size_t>(phase)];
+        }
+    };
+
+    void record(std::string_view route, const Timing &);
+    void render(std::string &);
+    void appendHelp(std::string &, std::string_view name, std::string_view type, std::string_view help);
+    void appendSample(std::string &, std::string_view name, std::string_view labels, double value);
+}
@@ -13,8 +13,7 @@ namespace Server::Ping {
 
     class Handler final : public ProtoHandler {
         static inline const auto s_pongResponse = std::make_shared<Http::ConstantResponse>(
-            "HTTP/1.1 200 OK\r\n"
-            "Connection: close\r\n"
+            "HTTP/1.1 200 OK\r\n"sv,
             "Pragma: no-cache\r\n"
             "Cache-Control: no-cache, private\r\n"
             "Content-Type: application/json\r\n"
@@ -7,10 +7,13 @@
 #include "http_request.h"
 #include <log/write.h>
 #include <cassert>
+#include <functional>
 
 namespace Server {
     class ProtoHandler {
     public:
+        using Completion = std::function<void()>;
+
         ProtoHandler() = default;
         ProtoHandler(const ProtoHandler &) = default;
         ProtoHandler(ProtoHandler &&) = default;
@@ -22,6 +25,13 @@ namespace Server {
         [[nodiscard]] virtual bool asyncReady() const noexcept = 0;
         virtual void operator()(Http::Request &) const noexcept = 0;
 
+        // Обработчик, который ждёт освободившегося ресурса, может не занимать поток: он вызывает done,
+        // когда ответ сформирован, возможно, позже и из другого потока.
+        virtual void operator()(Http::Request & request, Completion done) const noexcept {
+            (*this)(request);
+            done();
+        }
+
         static void fail(
             Http::Request & request,
             const Http::Status status,
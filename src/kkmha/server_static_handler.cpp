@@ -4,14 +4,22 @@
 #include "server_static_handler.h"
 #include "server_static_variables.h"
 #include "server_static_strings.h"
+#include "server_static_watcher.h"
 #include "http_solid_response.h"
 #include "http_binary_response.h"
+#include "http_serialized_response.h"
+#include "http_not_modified_response.h"
+#include "http_gzip.h"
 #include "server_cache_strings.h"
 #include "server_cache_core.h"
+#include "server_variables.h"
 #include <lib/except.h>
 #include <lib/path.h>
 #include <cassert>
+#include <algorithm>
+#include <chrono>
 #include <fstream>
+#include <string>
 
 namespace Server::Static {
     using namespace std::string_view_literals;
@@ -29,6 +37,45 @@ namespace Server::Static {
             = std::make_shared<Http::SolidResponse>(std::format(Mbs::c_redirectResponseTemplate, newPath));
     }
 
+    // Список валидаторов из If-None-Match; слабые валидаторы (W/) сравниваются без учёта признака.
+    [[nodiscard]]
+    bool matches(const std::string_view condition, const std::string_view tag) noexcept {
+        for (size_t first = 0; first < condition.size();) {
+            const auto last = condition.find(',', first);
+            auto candidate = condition.substr(first, last == std::string_view::npos ? last : last - first);
+            candidate.remove_prefix(std::min(candidate.find_first_not_of(' '), candidate.size()));
+            candidate.remove_suffix(candidate.size() - std::min(candidate.find_last_not_of(' ') + 1, candidate.size()));
+            if (candidate.starts_with("W/"sv)) {
+                candidate.remove_prefix(2);
+            }
+            if (candidate == "*"sv || candidate == tag) {
+                return true;
+            }
+            if (last == std::string_view::npos) {
+                break;
+            }
+            first = last + 1;
+        }
+        return false;
+    }
+
+    // Валидатор сравнивается с тем вариантом, который будет отдан клиенту: у сжатого он свой.
+    void respond(Http::Request & request, const Cache::Entry & entry, const std::string_view condition) {
+        if (!condition.empty() && !entry.m_tag.empty()) {
+            const bool gzipped {
+                s_compressionThreshold > 0 && !entry.m_data->m_gzipped.m_bytes.empty()
+                && Http::Gzip::accepted(request.m_header[Http::Field::AcceptEncoding])
+            };
+            if (auto tag = Http::codedTag(entry.m_tag, gzipped); matches(condition, tag)) {
+                request.m_response.m_status = Http::Status::NotModified;
+                request.m_response.m_data = std::make_shared<Http::NotModifiedResponse>(tag, entry.m_data->m_varied);
+                return;
+            }
+        }
+        request.m_response.m_status = entry.m_status;
+        request.m_response.m_data = entry.m_data;
+    }
+
     bool Handler::asyncReady() const noexcept {
         return false;
     }
@@ -59,53 +106,59 @@ namespace Server::Static {
             }
             path2.assign(requestedPath, pos);
             path /= path2;
-            if (std::filesystem::is_directory(path)) {
-                return redirectToIndex(request);
-            }
-            if (!std::filesystem::is_regular_file(path)) {
-                return fail(request, Http::Status::NotFound, Server::Mbs::c_notFound);
-            }
-        }
-
-        std::error_code error;
-
-        {
-            auto status = std::filesystem::status(path, error);
-            if (error) {
-                return fail(request, Http::Status::NotFound, error.message());
-            }
-            if (status.type() != std::filesystem::file_type::regular) {
-                return fail(request, Http::Status::NotFound, Mbs::c_badFilesystemEntityType);
-            }
         }
 
-        Cache::maintain();
+        // Поколение берётся до обращения к файлу: если файл изменится во время чтения, прочитанное
+        // сохранится с устаревшим поколением и отдаваться не будет. Поколение хранится в записи, а не в ключе,
+        // поэтому новая запись заменяет устаревшую, а не копится рядом с ней до истечения срока.
+        const bool watched { Watcher::active() };
+        const auto generation = Watcher::generation();
         Cache::Key cacheKey { "static::::" };
         cacheKey.append(Text::convert(path.native()));
 
+        const auto ifNoneMatch = request.m_header.find("if-none-match");
+        const std::string_view condition {
+            ifNoneMatch == request.m_header.end() ? std::string_view {} : ifNoneMatch->second
+        };
+
+        std::error_code error;
+
+        // Пока работает отслеживание изменений, попадание в кэш обходится без обращений к файловой системе.
         if (auto cacheEntry = Cache::load(cacheKey); cacheEntry) {
-            auto fileTime = std::filesystem::last_write_time(path, error);
-            if (error) {
-                return fail(request, Http::Status::NotFound, error.message());
+            bool actual { watched && cacheEntry->m_generation == generation };
+            if (!watched) {
+                auto fileTime = std::filesystem::last_write_time(path, error);
+                if (error) {
+                    return fail(request, Http::Status::NotFound, error.message());
+                }
+                actual = DateTime::cast<DateTime::Point>(fileTime) <= cacheEntry->m_cachedAt;
             }
-            if (DateTime::cast<DateTime::Point>(fileTime) <= cacheEntry->m_cachedAt) {
-                request.m_response.m_status = cacheEntry->m_status;
-                request.m_response.m_data = cacheEntry->m_data;
+            if (actual) {
                 LOG_DEBUG_TS(Cache::Wcs::c_fromCache, request.m_id);
-                return;
+                return respond(request, *cacheEntry, condition);
             }
         }
 
-        size_t fileSize {};
+        // Тип, время изменения и размер читаются одним запросом к файловой системе и берутся из directory_entry.
+        const std::filesystem::directory_entry file { path, error };
+        if (!error && file.is_directory(error)) {
+            return redirectToIndex(request);
+        }
+        if (error || !file.is_regular_file(error)) {
+            return fail(request, Http::Status::NotFound, Server::Mbs::c_notFound);
+        }
+
+        const auto fileTime = file.last_write_time(error);
+        if (error) {
+            return fail(request, Http::Status::NotFound, error.message());
+        }
 
-        {
-            fileSize = std::filesystem::file_size(path, error);
-            if (error) {
-                return fail(request, Http::Status::NotFound, error.message());
-            }
-            if (fileSize > c_fileSizeLimit) {
-                return fail(request, Http::Status::NotFound, Mbs::c_fileTooLarge);
-            }
+        const auto fileSize = static_cast<size_t>(file.file_size(error));
+        if (error) {
+            return fail(request, Http::Status::NotFound, error.message());
+        }
+        if (fileSize > c_fileSizeLimit) {
+            return fail(request, Http::Status::NotFound, Mbs::c_fileTooLarge);
         }
 
         auto response = std::make_shared<Http::BinaryResponse<Http::Shared>>();
@@ -122,6 +175,15 @@ namespace Server::Static {
             }
         }
 
+        // Валидатор строится из размера и времени изменения, поэтому совпадает между перезапусками службы.
+        response->m_tag = std::format(Mbs::c_etagTemplate, fileSize, fileTime.time_since_epoch().count());
+        response->m_headers.append(
+            std::format(
+                Mbs::c_lastModifiedTemplate,
+                std::chrono::floor<std::chrono::seconds>(DateTime::cast<DateTime::Point>(fileTime))
+            )
+        );
+
         if (fileSize > 0) {
             response->m_data = std::make_shared_for_overwrite<char[]>(fileSize);
             std::ifstream file { path, std::ios::binary };
@@ -130,11 +192,20 @@ namespace Server::Static {
             }
         }
 
-        Cache::store(cacheKey, Cache::expiresAfter(c_fileCacheLifeTime), request.m_response.m_status, response);
         assert(request.m_response.m_status == Http::Status::Ok);
-        if (request.m_response.m_status == Http::Status::Ok) {
-            request.m_response.m_data = std::move(response);
-        }
+        Cache::Entry entry {
+            .m_data
+                = Http::SerializedResponse::from(
+                    *response, Http::Status::Ok, static_cast<size_t>(s_compressionThreshold)
+                ),
+            .m_cachedAt = DateTime::Clock::now(),
+            .m_expiredAt = Cache::expiresAfter(c_fileCacheLifeTime),
+            .m_status = Http::Status::Ok,
+            .m_tag = response->m_tag,
+            .m_generation = generation
+        };
+        respond(request, entry, condition);
+        Cache::store(cacheKey, std::move(entry));
 
     } catch (const Failure & e) {
         fail(request, Http::Status::InternalServerError, Text::convert(e.what()), e.where());
@@ -10,6 +10,11 @@ namespace Server::Static {
         using Csv = const std::wstring_view;
 
         constexpr Csv c_incorrectStructure { L"Конфигурационный файл '{}' содержит ошибки" };
+        constexpr Csv c_watcherStarted { L"Отслеживание изменений в директории '{}' запущено" };
+        constexpr Csv c_watcherFailed {
+            L"Отслеживание изменений в директории '{}' прекращено: {}. Файлы будут проверяться при каждом запросе"
+        };
+        constexpr Csv c_staticChanged { L"Содержимое директории статических файлов изменилось, кэш файлов сброшен" };
     }
 
     namespace Mbs {
@@ -17,7 +22,8 @@ namespace Server::Static {
 
         constexpr Csv c_fileTooLarge { "Размер файла превышает разрешённый" };
         constexpr Csv c_unknownMimeType { "Неизвестный тип файла" };
-        constexpr Csv c_badFilesystemEntityType { "Неподходящий тип объекта файловой системы" };
+        constexpr Csv c_etagTemplate { "\"{:x}-{:x}\"" };
+        constexpr Csv c_lastModifiedTemplate { "Last-Modified: {:%a, %d %b %Y %H:%M:%S} GMT\r\n" };
 
         constexpr Csv c_redirectResponseTemplate {
             "HTTP/1.1 302 Moved Temporarily\r\n"
@@ -0,0 +1,130 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#include "server_static_watcher.h"
+#include "server_static_variables.h"
+#include "server_static_strings.h"
+#include <lib/winapi.h>
+#include <lib/errexp.h>
+#include <lib/except.h>
+#include <log/write.h>
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <string_view>
+#include <thread>
+
+namespace Server::Static::Watcher {
+    constexpr ::DWORD c_filter {
+        FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_SIZE
+        | FILE_NOTIFY_CHANGE_LAST_WRITE
+    };
+
+    static std::atomic<uint64_t> s_generation { 0 };
+    static std::atomic<bool> s_active { false };
+    static ::HANDLE s_handle { INVALID_HANDLE_VALUE };
+    static ::HANDLE s_stopEvent { nullptr };
+    static std::thread s_thread {};
+
+    static void closeHandles() noexcept {
+        if (s_handle != INVALID_HANDLE_VALUE) {
+            ::CloseHandle(s_handle);
+            s_handle = INVALID_HANDLE_VALUE;
+        }
+        if (s_stopEvent) {
+            ::CloseHandle(s_stopEvent);
+            s_stopEvent = nullptr;
+        }
+    }
+
+    static void warn(const std::wstring_view operation) noexcept {
+        const auto error = ::GetLastError();
+        LOG_WARNING_TS(Wcs::c_watcherFailed, s_directory.native(), System::explainError(operation, error));
+    }
+
+    // Содержимое уведомлений не разбирается: статические файлы меняются редко, и при любом изменении
+    // (в том числе при переполнении буфера уведомлений) проще сбросить все файлы разом.
+    static void watch() noexcept {
+        alignas(::DWORD) std::array<std::byte, 16'384> buffer {};
+        ::OVERLAPPED overlapped {};
+        overlapped.hEvent = ::CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (!overlapped.hEvent) {
+            warn(L"CreateEventW");
+            s_active.store(false);
+            return;
+        }
+
+        for (;;) {
+            ::ResetEvent(overlapped.hEvent);
+            if (!::ReadDirectoryChangesW(
+                s_handle, buffer.data(), static_cast<::DWORD>(buffer.size()), TRUE, c_filter, nullptr,
+                &overlapped, nullptr
+            )) {
+                warn(L"ReadDirectoryChangesW");
+                break;
+            }
+
+            const std::array<::HANDLE, 2> events { overlapped.hEvent, s_stopEvent };
+            const auto signaled = ::WaitForMultipleObjects(2, events.data(), FALSE, INFINITE);
+            ::DWORD size { 0 };
+            if (signaled != WAIT_OBJECT_0) {
+                ::CancelIoEx(s_handle, &overlapped);
+                ::GetOverlappedResult(s_handle, &overlapped, &size, TRUE);
+                break;
+            }
+            if (!::GetOverlappedResult(s_handle, &overlapped, &size, FALSE)) {
+                warn(L"GetOverlappedResult");
+                break;
+            }
+
+            s_generation.fetch_add(1);
+            LOG_DEBUG_TS(Wcs::c_staticChanged);
+        }
+
+        s_active.store(false);
+        ::CloseHandle(overlapped.hEvent);
+    }
+
+    void start() {
+        if (!s_enable || s_thread.joinable()) {
+            return;
+        }
+
+        s_handle
+            = ::CreateFileW(
+                s_directory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr
+            );
+        if (s_handle == INVALID_HANDLE_VALUE) {
+            warn(L"CreateFileW");
+            return;
+        }
+        s_stopEvent = ::CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (!s_stopEvent) {
+            warn(L"CreateEventW");
+            closeHandles();
+            return;
+        }
+
+        s_active.store(true);
+        s_thread = std::thread(watch);
+        LOG_DEBUG_TS(Wcs::c_watcherStarted, s_directory.native());
+    }
+
+    void stop() noexcept {
+        if (s_thread.joinable()) {
+            ::SetEvent(s_stopEvent);
+            s_thread.join();
+        }
+        closeHandles();
+        s_active.store(false);
+    }
+
+    bool active() noexcept {
+        return s_active.load();
+    }
+
+    uint64_t generation() noexcept {
+        return s_generation.load();
+    }
+}
@@ -0,0 +1,18 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#pragma once
+
+#include <cstdint>
+
+// Отслеживание изменений в директории статических файлов (ReadDirectoryChangesW). Любое изменение
+// увеличивает поколение; закэшированный файл другого поколения считается устаревшим и перечитывается
+// под тем же ключом, так что обращаться к файловой системе при каждом запросе не нужно.
+namespace Server::Static::Watcher {
+    void start();
+    void stop() noexcept;
+
+    // Пока отслеживание не работает, актуальность закэшированного файла проверяется по времени изменения.
+    [[nodiscard]] bool active() noexcept;
+    [[nodiscard]] uint64_t generation() noexcept;
+}
@@ -22,10 +22,40 @@ namespace Server {
         constexpr Csv c_servicingFailed { L"Сбой сервера" };
         constexpr Csv c_socketOpeningError { L"Ошибка открытия сокета" };
         constexpr Csv c_maximumIsExceeded { L"Превышено разрешенное количество одновременных запросов" };
+        constexpr Csv c_admissionTimeout { L"Превышено время ожидания в очереди на обслуживание" };
+        constexpr Csv c_admissionSummary {
+            L"Допуск соединений: допущено {}, ожидали в очереди {}, пик очереди {}, переполнений {}, таймаутов {}, "
+            L"отменено {}"
+        };
         constexpr Csv c_timeoutExpired { L"Превышена разрешенная длительность выполнения запроса" };
         constexpr Csv c_processingSuccess { L"Запрос успешно обработан" };
         constexpr Csv c_processingFailed { L"Не удалось обработать запрос" };
-        constexpr Csv c_cacheMaintain { L"Обслуживание кэша (размер {} => {})" };
+        constexpr Csv c_reactorsStarted { L"Запущено реакторов ввода-вывода: {}" };
+        constexpr Csv c_reactorAssigned { L"Соединение передано реактору #{} (активных соединений: {})" };
+        constexpr Csv c_reactorSummary { L"Реактор #{}: принято соединений {}" };
+        constexpr Csv c_sessionResumed { L"TLS-сессия возобновлена" };
+        constexpr Csv c_ticketKeyFailed { L"Не удалось сгенерировать ключ билетов TLS-сессий" };
+        constexpr Csv c_ticketKeyRotated { L"Ключ билетов TLS-сессий обновлён (ротация №{})" };
+        constexpr Csv c_tlsSessionsSummary {
+            L"TLS-рукопожатия: полных {}, возобновлённых {}, ротаций ключа билетов {}"
+        };
+        constexpr Csv c_keepAliveClosed { L"Постоянное соединение закрыто" };
+        constexpr Csv c_pipelined { L"Запрос уже получен вместе с предыдущим" };
+        constexpr Csv c_http2Negotiated { L"Согласован протокол HTTP/2" };
+        constexpr Csv c_journalReplayed {
+            L"Журнал идемпотентности: восстановлено записей: {} (прочитано {}) за {} мс"
+        };
+        constexpr Csv c_journalDamaged { L"Журнал идемпотентности: отброшен повреждённый хвост ({} байт)" };
+        constexpr Csv c_journalCompacted { L"Журнал идемпотентности перестроен ({} => {} байт, записей: {})" };
+        constexpr Csv c_journalFailed { L"Журнал идемпотентности отключён: {}" };
+        constexpr Csv c_workerPoolStarted { L"Пул обработчиков запущен (потоков: {})" };
+        constexpr Csv c_workerPoolStopped {
+            L"Пул обработчиков остановлен (выполнено задач: {}, пик очереди: {}, "
+            L"среднее ожидание: {} мкс, максимальное ожидание: {} мкс)"
+        };
+        constexpr Csv c_workerPoolQueued {
+            L"Запрос [{:04x}]: Ожидание в очереди обработчиков {} мкс (в очереди: {}, занято потоков: {} из {})"
+        };
     }
 
     namespace Mbs {
@@ -57,5 +87,6 @@ namespace Server {
         constexpr Csv c_sslWriteOperation { "SSL write" };
         constexpr Csv c_sslShutdownOperation { "SSL shutdown" };
         constexpr Csv c_socketCloseOperation { "Socket close" };
+        constexpr Csv c_http2Operation { "HTTP/2" };
     }
 }
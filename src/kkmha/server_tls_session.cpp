@@ -0,0 +1,161 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#include "server_tls_session.h"
+#include "server_variables.h"
+#include "server_strings.h"
+#include <lib/except.h>
+#include <log/write.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/core_names.h>
+#include <cstring>
+#include <atomic>
+#include <mutex>
+#include <array>
+
+namespace Server::TlsSession {
+    // Ключ шифрования билетов сессий (RFC 5077). Билеты, выпущенные предыдущим ключом, ещё принимаются,
+    // но клиент получает новый билет. Билеты более старых ключей отвергаются - выполняется полное рукопожатие.
+    struct TicketKey {
+        std::array<unsigned char, 16> m_name;
+        std::array<unsigned char, 32> m_aesKey;
+        std::array<unsigned char, 32> m_hmacKey;
+    };
+
+    static constexpr unsigned char c_sessionIdContext[] { 'k', 'k', 'm', 'h', 'a' };
+    static constexpr char c_ticketDigest[] { "SHA256" };
+
+    static std::array<TicketKey, 2> s_ticketKeys {}; // [0] - текущий, [1] - предыдущий
+    static std::mutex s_ticketKeysMutex {};
+    static std::atomic<uint64_t> s_full { 0 };
+    static std::atomic<uint64_t> s_resumed { 0 };
+    static std::atomic<uint64_t> s_keyRotations { 0 };
+
+    [[nodiscard]]
+    inline TicketKey generateKey() {
+        TicketKey key {};
+        if (
+            ::RAND_bytes(key.m_name.data(), static_cast<int>(key.m_name.size())) != 1
+            || ::RAND_bytes(key.m_aesKey.data(), static_cast<int>(key.m_aesKey.size())) != 1
+            || ::RAND_bytes(key.m_hmacKey.data(), static_cast<int>(key.m_hmacKey.size())) != 1
+        ) {
+            throw Basic::Failure(Wcs::c_ticketKeyFailed); // NOLINT(*-exception-baseclass)
+        }
+        return key;
+    }
+
+    [[nodiscard]]
+    inline bool setupMac(EVP_MAC_CTX * hmacContext, TicketKey & key) {
+        std::array params {
+            ::OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, key.m_hmacKey.data(), key.m_hmacKey.size()),
+            ::OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char *>(c_ticketDigest), 0),
+            ::OSSL_PARAM_construct_end()
+        };
+        return ::EVP_MAC_CTX_set_params(hmacContext, params.data()) == 1;
+    }
+
+    int ticketKeyCallback(
+        SSL *,
+        unsigned char * keyName,
+        unsigned char * iv,
+        EVP_CIPHER_CTX * cipherContext,
+        EVP_MAC_CTX * hmacContext,
+        const int encrypt
+    ) {
+        TicketKey key {};
+        int result { 1 };
+
+        {
+            std::scoped_lock ticketKeysLock(s_ticketKeysMutex);
+            if (encrypt) {
+                key = s_ticketKeys[0];
+            } else if (std::memcmp(keyName, s_ticketKeys[0].m_name.data(), s_ticketKeys[0].m_name.size()) == 0) {
+                key = s_ticketKeys[0];
+            } else if (std::memcmp(keyName, s_ticketKeys[1].m_name.data(), s_ticketKeys[1].m_name.size()) == 0) {
+                key = s_ticketKeys[1];
+                result = 2; // Билет принят, но его нужно перевыпустить текущим ключом
+            } else {
+                return 0;
+            }
+        }
+
+        if (encrypt) {
+            const int ivLength = ::EVP_CIPHER_get_iv_length(::EVP_aes_256_cbc());
+            if (::RAND_bytes(iv, ivLength) != 1) {
+                return -1;
+            }
+            std::memcpy(keyName, key.m_name.data(), key.m_name.size());
+            if (
+                ::EVP_EncryptInit_ex(cipherContext, ::EVP_aes_256_cbc(), nullptr, key.m_aesKey.data(), iv) != 1
+                || !setupMac(hmacContext, key)
+            ) {
+                return -1;
+            }
+            return 1;
+        }
+
+        if (
+            !setupMac(hmacContext, key)
+            || ::EVP_DecryptInit_ex(cipherContext, ::EVP_aes_256_cbc(), nullptr, key.m_aesKey.data(), iv) != 1
+        ) {
+            return -1;
+        }
+        return result;
+    }
+
+    void configure(Asio::SslContext & sslContext) {
+        auto context = sslContext.native_handle();
+
+        ::SSL_CTX_set_session_id_context(context, c_sessionIdContext, sizeof(c_sessionIdContext));
+        if (s_sessionCacheSize > 0) {
+            ::SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_SERVER);
+            ::SSL_CTX_sess_set_cache_size(context, s_sessionCacheSize);
+        } else {
+            ::SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_OFF);
+        }
+        ::SSL_CTX_set_timeout(context, static_cast<long>(s_sessionTimeout));
+
+        if (s_sessionTickets) {
+            {
+                std::scoped_lock ticketKeysLock(s_ticketKeysMutex);
+                s_ticketKeys[0] = generateKey();
+                s_ticketKeys[1] = generateKey();
+            }
+            ::SSL_CTX_clear_options(context, SSL_OP_NO_TICKET);
+            ::SSL_CTX_set_tlsext_ticket_key_evp_cb(context, ticketKeyCallback);
+        } else {
+            ::SSL_CTX_set_options(context, SSL_OP_NO_TICKET);
+        }
+    }
+
+    void rotate() {
+        auto key = generateKey();
+
+        {
+            std::scoped_lock ticketKeysLock(s_ticketKeysMutex);
+            s_ticketKeys[1] = s_ticketKeys[0];
+            s_ticketKeys[0] = key;
+        }
+
+        ++s_keyRotations;
+        LOG_DEBUG_TS(Wcs::c_ticketKeyRotated, s_keyRotations.load());
+    }
+
+    bool handshaked(const SSL * ssl) noexcept {
+        if (::SSL_session_reused(ssl)) {
+            ++s_resumed;
+            return true;
+        }
+        ++s_full;
+        return false;
+    }
+
+    Stats stats() noexcept {
+        return {
+            .m_full = s_full.load(),
+            .m_resumed = s_resumed.load(),
+            .m_keyRotations = s_keyRotations.load()
+        };
+    }
+}
@@ -0,0 +1,20 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#pragma once
+
+#include "asio.h"
+#include <cstdint>
+
+namespace Server::TlsSession {
+    struct Stats {
+        uint64_t m_full;
+        uint64_t m_resumed;
+        uint64_t m_keyRotations;
+    };
+
+    void configure(Asio::SslContext &);
+    void rotate();
+    [[nodiscard]] bool handshaked(const SSL *) noexcept;
+    [[nodiscard]] Stats stats() noexcept;
+}
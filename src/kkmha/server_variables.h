@@ -9,13 +9,30 @@
 
 namespace Server {
     inline int64_t s_requestTimeout { c_defRequestTimeout };
+    inline int64_t s_keepAliveTimeout { c_defKeepAliveTimeout };
+    inline int64_t s_keepAliveMaxRequests { c_defKeepAliveMaxRequests };
     inline bool s_ipv4Only { c_defIpv4Only };
+    inline bool s_enableHttp2 { c_defEnableHttp2 };
     inline unsigned short s_port { c_defPort };
     inline int64_t s_concurrencyLimit { c_defConcurrencyLimit };
+    inline int64_t s_admissionQueueSize { c_defAdmissionQueueSize };
+    inline int64_t s_admissionTimeout { c_defAdmissionTimeout };
+    inline int64_t s_ioThreads { c_defIoThreads };
+    inline int64_t s_workerThreads { c_defWorkerThreads };
+    inline int64_t s_deviceIdleTimeout { c_defDeviceIdleTimeout };
+    inline int64_t s_statusPollInterval { c_defStatusPollInterval };
+    inline int64_t s_compressionThreshold { c_defCompressionThreshold };
+    inline int64_t s_cacheMemoryLimit { c_defCacheMemoryLimit };
     inline bool s_enableLegacyTls { false };
     inline int s_securityLevel { -1 };
+    inline int64_t s_sessionCacheSize { c_defSessionCacheSize };
+    inline int64_t s_sessionTimeout { c_defSessionTimeout };
+    inline bool s_sessionTickets { c_defSessionTickets };
+    inline int64_t s_ticketKeyRotation { c_defTicketKeyRotation };
     inline std::filesystem::path s_certificateChainFile { c_defCertificateChainFile };
     inline std::filesystem::path s_privateKeyFile { c_defPrivateKeyFile };
+    inline bool s_enableJournal { c_defEnableJournal };
+    inline std::filesystem::path s_journalFile { c_defJournalFile };
     inline std::string s_privateKeyPassword {};
     inline std::string s_secret { c_defSecret };
     inline bool s_loopbackWithoutSecret { c_loopbackWithoutSecret };
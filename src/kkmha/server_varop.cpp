@@ -13,17 +13,71 @@ namespace Server {
             json, "server",
             [] (const Nln::Json & json, const std::wstring & path) -> bool {
                 Json::handleKey(json, "ipv4Only", s_ipv4Only, path);
+                Json::handleKey(json, "enableHttp2", s_enableHttp2, path);
                 Json::handleKey(json, "port", s_port, Numeric::between(c_minPort, c_maxPort), path);
                 Json::handleKey(
                     json, "requestTimeout", s_requestTimeout,
                     Numeric::between(c_minRequestTimeout, c_maxRequestTimeout), path
                 );
+                Json::handleKey(
+                    json, "keepAliveTimeout", s_keepAliveTimeout,
+                    Numeric::between(c_minKeepAliveTimeout, c_maxKeepAliveTimeout), path
+                );
+                Json::handleKey(
+                    json, "keepAliveMaxRequests", s_keepAliveMaxRequests,
+                    Numeric::between(c_minKeepAliveMaxRequests, c_maxKeepAliveMaxRequests), path
+                );
                 Json::handleKey(
                     json, "concurrencyLimit", s_concurrencyLimit,
                     Numeric::between(c_minConcurrencyLimit, c_maxConcurrencyLimit), path
                 );
+                Json::handleKey(
+                    json, "admissionQueueSize", s_admissionQueueSize,
+                    Numeric::between(c_minAdmissionQueueSize, c_maxAdmissionQueueSize), path
+                );
+                Json::handleKey(
+                    json, "admissionTimeout", s_admissionTimeout,
+                    Numeric::between(c_minAdmissionTimeout, c_maxAdmissionTimeout), path
+                );
+                Json::handleKey(
+                    json, "ioThreads", s_ioThreads,
+                    Numeric::between(c_minIoThreads, c_maxIoThreads), path
+                );
+                Json::handleKey(
+                    json, "workerThreads", s_workerThreads,
+                    Numeric::between(c_minWorkerThreads, c_maxWorkerThreads), path
+                );
+                Json::handleKey(
+                    json, "deviceIdleTimeout", s_deviceIdleTimeout,
+                    Numeric::between(c_minDeviceIdleTimeout, c_maxDeviceIdleTimeout), path
+                );
+                Json::handleKey(
+                    json, "statusPollInterval", s_statusPollInterval,
+                    Numeric::between(c_minStatusPollInterval, c_maxStatusPollInterval), path
+                );
+                Json::handleKey(
+                    json, "compressionThreshold", s_compressionThreshold,
+                    Numeric::between(c_minCompressionThreshold, c_maxCompressionThreshold), path
+                );
+                Json::handleKey(
+                    json, "cacheMemoryLimit", s_cacheMemoryLimit,
+                    Numeric::between(c_minCacheMemoryLimit, c_maxCacheMemoryLimit), path
+                );
                 Json::handleKey(json, "enableLegacyTls", s_enableLegacyTls, path);
                 Json::handleKey(json, "securityLevel", s_securityLevel, Numeric::between(0, 5), path);
+                Json::handleKey(
+                    json, "sessionCacheSize", s_sessionCacheSize,
+                    Numeric::between(c_minSessionCacheSize, c_maxSessionCacheSize), path
+                );
+                Json::handleKey(
+                    json, "sessionTimeout", s_sessionTimeout,
+                    Numeric::between(c_minSessionTimeout, c_maxSessionTimeout), path
+                );
+                Json::handleKey(json, "sessionTickets", s_sessionTickets, path);
+                Json::handleKey(
+                    json, "ticketKeyRotation", s_ticketKeyRotation,
+                    Numeric::between(c_minTicketKeyRotation, c_maxTicketKeyRotation), path
+                );
                 Json::handleKey(
                     json, "certificateChainFile", s_certificateChainFile,
                     Path::existsFile(Path::absolute(Path::noEmpty())), path
@@ -33,6 +87,8 @@ namespace Server {
                     Path::existsFile(Path::absolute(Path::noEmpty())), path
                 );
                 Json::handleKey(json, "privateKeyPassword", s_privateKeyPassword, path);
+                Json::handleKey(json, "enableJournal", s_enableJournal, path);
+                Json::handleKey(json, "journalFile", s_journalFile, Path::absolute(Path::noEmpty()), path);
                 Json::handleKey(json, "secret", s_secret, path);
                 Json::handleKey(json, "loopbackWithoutSecret", s_loopbackWithoutSecret, path);
                 return true;
@@ -54,13 +110,30 @@ namespace Server {
         stream
             << L"CFG: server.ipv4Only = " << Text::Wcs::yesNo(s_ipv4Only) << L"\n"
             L"CFG: server.port = " << s_port << L"\n"
+            L"CFG: server.enableHttp2 = " << Text::Wcs::yesNo(s_enableHttp2) << L"\n"
             L"CFG: server.requestTimeout = " << s_requestTimeout << L"\n"
+            L"CFG: server.keepAliveTimeout = " << s_keepAliveTimeout << L"\n"
+            L"CFG: server.keepAliveMaxRequests = " << s_keepAliveMaxRequests << L"\n"
             L"CFG: server.concurrencyLimit = " << s_concurrencyLimit << L"\n"
+            L"CFG: server.admissionQueueSize = " << s_admissionQueueSize << L"\n"
+            L"CFG: server.admissionTimeout = " << s_admissionTimeout << L"\n"
+            L"CFG: server.ioThreads = " << s_ioThreads << L"\n"
+            L"CFG: server.workerThreads = " << s_workerThreads << L"\n"
+            L"CFG: server.deviceIdleTimeout = " << s_deviceIdleTimeout << L"\n"
+            L"CFG: server.statusPollInterval = " << s_statusPollInterval << L"\n"
+            L"CFG: server.compressionThreshold = " << s_compressionThreshold << L"\n"
+            L"CFG: server.cacheMemoryLimit = " << s_cacheMemoryLimit << L"\n"
             L"CFG: server.enableLegacyTls = " << Text::Wcs::yesNo(s_enableLegacyTls) << L"\n"
             L"CFG: server.securityLevel = " << securityLevel << L"\n"
+            L"CFG: server.sessionCacheSize = " << s_sessionCacheSize << L"\n"
+            L"CFG: server.sessionTimeout = " << s_sessionTimeout << L"\n"
+            L"CFG: server.sessionTickets = " << Text::Wcs::yesNo(s_sessionTickets) << L"\n"
+            L"CFG: server.ticketKeyRotation = " << s_ticketKeyRotation << L"\n"
             L"CFG: server.certificateChainFile = \"" << s_certificateChainFile.native() << L"\"\n"
             L"CFG: server.privateKeyFile = \"" << s_privateKeyFile.native() << L"\"\n"
             L"CFG: server.privateKeyPassword = \"" << Text::convert(s_privateKeyPassword) << L"\"\n"
+            L"CFG: server.enableJournal = " << Text::Wcs::yesNo(s_enableJournal) << L"\n"
+            L"CFG: server.journalFile = \"" << s_journalFile.native() << L"\"\n"
             L"CFG: server.secret = \"" << Text::convert(s_secret) << L"\"\n"
             L"CFG: server.loopbackWithoutSecret = " << Text::Wcs::yesNo(s_loopbackWithoutSecret) << L"\n";
 
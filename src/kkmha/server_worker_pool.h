@@ -0,0 +1,221 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#pragma once
+
+#include <cassert>
+#include <concepts>
+#include <utility>
+#include <memory>
+#include <exception>
+#include <system_error>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <deque>
+#include <vector>
+
+namespace Server {
+    class WorkerPool {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using Duration = std::chrono::microseconds;
+
+        struct Stats {
+            int64_t m_threads;
+            int64_t m_busy;
+            int64_t m_queueDepth;
+            int64_t m_queuePeak;
+            uint64_t m_completed;
+            Duration m_waitTotal;
+            Duration m_waitMax;
+        };
+
+    private:
+        class Task {
+        public:
+            Task() = default;
+            Task(const Task &) = delete;
+            Task(Task &&) = delete;
+            virtual ~Task() = default;
+
+            Task & operator=(const Task &) = delete;
+            Task & operator=(Task &&) = delete;
+
+            virtual void operator()(Duration) = 0;
+            virtual void fail(std::exception_ptr) noexcept = 0;
+        };
+
+        template<std::invocable<WorkerPool::Duration> T, std::invocable<std::exception_ptr> F>
+        class Job final : public Task {
+            T m_func;
+            F m_fail;
+
+        public:
+            Job() = delete;
+            Job(const Job &) = delete;
+            Job(Job &&) = delete;
+            Job(T && func, F && fail) : m_func(std::forward<T>(func)), m_fail(std::forward<F>(fail)) {}
+            ~Job() override = default;
+
+            Job & operator=(const Job &) = delete;
+            Job & operator=(Job &&) = delete;
+
+            void operator()(const Duration waited) override {
+                m_func(waited);
+            }
+
+            void fail(std::exception_ptr error) noexcept override {
+                try {
+                    m_fail(std::move(error));
+                } catch (...) {}
+            }
+        };
+
+        // Для фоновых задач, которые сами обрабатывают свои ошибки и результата не ждут.
+        struct Unobserved {
+            void operator()(std::exception_ptr) const noexcept {}
+        };
+
+        struct Item {
+            std::unique_ptr<Task> m_task;
+            Clock::time_point m_queuedAt;
+        };
+
+        std::mutex m_mutex {};
+        std::condition_variable m_condition {};
+        std::deque<Item> m_queue {};
+        std::vector<std::thread> m_threads {};
+        bool m_stopping { false };
+        std::atomic<int64_t> m_busy { 0 };
+        std::atomic<int64_t> m_queueDepth { 0 };
+        std::atomic<int64_t> m_queuePeak { 0 };
+        std::atomic<uint64_t> m_completed { 0 };
+        std::atomic<int64_t> m_waitTotal { 0 }; // Микросекунды
+        std::atomic<int64_t> m_waitMax { 0 }; // Микросекунды
+
+        void work() {
+            for (;;) {
+                Item item {};
+
+                {
+                    std::unique_lock lock { m_mutex };
+                    m_condition.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+                    if (m_stopping) {
+                        return;
+                    }
+                    item = std::move(m_queue.front());
+                    m_queue.pop_front();
+                    --m_queueDepth;
+                    ++m_busy;
+                }
+
+                const auto waited = std::chrono::duration_cast<Duration>(Clock::now() - item.m_queuedAt);
+                m_waitTotal += waited.count();
+                for (auto max = m_waitMax.load(); max < waited.count();) {
+                    if (m_waitMax.compare_exchange_weak(max, waited.count())) {
+                        break;
+                    }
+                }
+
+                // Исключение задачи передаётся её владельцу: тот, кто ждёт завершения, должен его дождаться.
+                try {
+                    (*item.m_task)(waited);
+                } catch (...) {
+                    item.m_task->fail(std::current_exception());
+                }
+
+                item.m_task.reset();
+                ++m_completed;
+                --m_busy;
+            }
+        }
+
+    public:
+        WorkerPool() = default;
+        WorkerPool(const WorkerPool &) = delete;
+        WorkerPool(WorkerPool &&) = delete;
+        ~WorkerPool() { stop(); }
+
+        WorkerPool & operator=(const WorkerPool &) = delete;
+        WorkerPool & operator=(WorkerPool &&) = delete;
+
+        void start(const int64_t threads) {
+            assert(threads > 0);
+            std::scoped_lock lock { m_mutex };
+            assert(m_threads.empty());
+            m_stopping = false;
+            m_threads.reserve(static_cast<size_t>(threads));
+            for (int64_t i = 0; i < threads; ++i) {
+                m_threads.emplace_back(&WorkerPool::work, this);
+            }
+        }
+
+        void stop() {
+            std::deque<Item> dropped {};
+
+            {
+                std::scoped_lock lock { m_mutex };
+                m_stopping = true;
+                dropped.swap(m_queue);
+                m_queueDepth = 0;
+            }
+
+            m_condition.notify_all();
+            for (auto & thread : m_threads) {
+                if (thread.joinable()) {
+                    thread.join();
+                }
+            }
+            m_threads.clear();
+
+            // Невыполненные задачи не выбрасываются молча: их владельцы получают ошибку отмены.
+            for (auto & item : dropped) {
+                item.m_task->fail(
+                    std::make_exception_ptr(std::system_error(std::make_error_code(std::errc::operation_canceled)))
+                );
+            }
+        }
+
+        template<std::invocable<WorkerPool::Duration> T>
+        void submit(T && func) {
+            submit(std::forward<T>(func), Unobserved {});
+        }
+
+        // Задача выполняется функцией func; если она выбросила исключение или была снята с очереди
+        // при остановке пула, вместо неё вызывается fail.
+        template<std::invocable<WorkerPool::Duration> T, std::invocable<std::exception_ptr> F>
+        void submit(T && func, F && fail) {
+            {
+                std::scoped_lock lock { m_mutex };
+                assert(!m_stopping);
+                m_queue.emplace_back(
+                    std::make_unique<Job<std::remove_cvref_t<T>, std::remove_cvref_t<F>>>(
+                        std::forward<T>(func), std::forward<F>(fail)
+                    ),
+                    Clock::now()
+                );
+                const auto depth = ++m_queueDepth;
+                if (depth > m_queuePeak) {
+                    m_queuePeak = depth;
+                }
+            }
+            m_condition.notify_one();
+        }
+
+        [[nodiscard]]
+        Stats stats() const noexcept {
+            return {
+                .m_threads = static_cast<int64_t>(m_threads.size()),
+                .m_busy = m_busy.load(),
+                .m_queueDepth = m_queueDepth.load(),
+                .m_queuePeak = m_queuePeak.load(),
+                .m_completed = m_completed.load(),
+                .m_waitTotal = Duration(m_waitTotal.load()),
+                .m_waitMax = Duration(m_waitMax.load())
+            };
+        }
+    };
+}
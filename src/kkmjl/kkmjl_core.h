@@ -11,6 +11,7 @@
 #include <kkm/device.h>
 #include <kkm/impex.h>
 #include <kkm/callhelpers.h>
+#include <kkm/operations.h>
 #include <cstdlib>
 #include <filesystem>
 #include <iostream>
@@ -44,94 +45,116 @@ namespace KkmJsonLoader {
             }
         }
 
-        std::wstring query {};
+        std::string query {};
         if (details.contains(Mbs::c_query)) {
-            query.assign(Text::convert(Text::lowered(details.at(Mbs::c_query).get<std::string>())));
+            query.assign(details.at(Mbs::c_query).get<std::string>());
         } else {
             throw Basic::Failure(KKM_FMT(Kkm::Mbs::c_requiresProperty, Mbs::c_query)); // NOLINT(*-exception-baseclass)
         }
 
         Nln::Json result(Nln::EmptyJsonObject);
-        if (query == L"learn") {
-            std::wstring connString;
-            const bool found { Json::handleKey(details, "connParams", connString) };
-            if (!found) {
-                throw Basic::Failure(KKM_FMT(Kkm::Mbs::c_requiresProperty, "connParams")); // NOLINT(*-exception-baseclass)
+        switch (operation(query)) {
+            case Operation::Learn: {
+                std::wstring connString;
+                const bool found { Json::handleKey(details, "connParams", connString) };
+                if (!found) {
+                    throw Basic::Failure(KKM_FMT(Kkm::Mbs::c_requiresProperty, "connParams")); // NOLINT(*-exception-baseclass)
+                }
+                NewConnParams connParams { connString };
+                Device kkm { connParams };
+                connParams.save(kkm.serialNumber());
+                StatusResult statusResult {};
+                kkm.getStatus(statusResult);
+                kkm.printHello();
+                result << statusResult;
+                break;
             }
-            NewConnParams connParams { connString };
-            Device kkm { connParams };
-            connParams.save(kkm.serialNumber());
-            StatusResult statusResult {};
-            kkm.getStatus(statusResult);
-            kkm.printHello();
-            result << statusResult;
-        } else if (query == L"base-status") {
-            callMethod(Device { KnownConnParams { serial } }, &Device::getStatus, result);
-        } else if (query == L"status") {
-            collectDataFromMethods(
-                result,
-                Device { KnownConnParams { serial } },
-                &Device::getStatus,
-                &Device::getShiftState,
-                &Device::getReceiptState,
-                &Device::getCashStat,
-                &Device::getFndtOfdExchangeStatus,
-                &Device::getFndtLastReceipt,
-                &Device::getFndtLastDocument,
-                &Device::getFndtErrors
-            );
-        } else if (query == L"full-status") {
-            collectDataFromMethods(
-                result,
-                Device { KnownConnParams { serial } },
-                &Device::getStatus,
-                &Device::getShiftState,
-                &Device::getReceiptState,
-                &Device::getCashStat,
-                &Device::getFndtOfdExchangeStatus,
-                &Device::getFndtFnInfo,
-                &Device::getFndtRegistrationInfo,
-                &Device::getFndtLastRegistration,
-                &Device::getFndtLastReceipt,
-                &Device::getFndtLastDocument,
-                &Device::getFndtErrors,
-                &Device::getFfdVersion,
-                &Device::getFwVersion
-            );
-        } else if (query == L"print-demo") {
-            callMethod(Device { KnownConnParams { serial } }, &Device::printDemo, result);
-        } else if (query == L"print-non-fiscal-doc") {
-            callMethod(Device { KnownConnParams { serial } }, &Device::printNonFiscalDocument, details, result);
-        } else if (query == L"print-info") {
-            callMethod(Device { KnownConnParams { serial } }, &Device::printInfo, result);
-        } else if (query == L"print-fn-registrations") {
-            callMethod(Device { KnownConnParams { serial } }, &Device::printFnRegistrations, result);
-        } else if (query == L"print-ofd-exchange-status") {
-            callMethod(Device { KnownConnParams { serial } }, &Device::printOfdExchangeStatus, result);
-        } else if (query == L"print-ofd-test") {
-            callMethod(Device { KnownConnParams { serial } }, &Device::printOfdTest, result);
-        } else if (query == L"print-close-shift-reports") {
-            callMethod(Device { KnownConnParams { serial } }, &Device::printCloseShiftReports, result);
-        } else if (query == L"print-last-document") {
-            callMethod(Device { KnownConnParams { serial } }, &Device::printLastDocument, result);
-        } else if (query == L"cash-stat") {
-            callMethod(Device { KnownConnParams { serial } }, &Device::getCashStat, result);
-        } else if (query == L"cash-in") {
-            callMethod(Device { KnownConnParams { serial } }, &Device::registerCashIn, details, result);
-        } else if (query == L"cash-out") {
-            callMethod(Device { KnownConnParams { serial } }, &Device::registerCashOut, details, result);
-        } else if (query == L"sell") {
-            callMethod(Device { KnownConnParams { serial } }, &Device::registerSell, details, result);
-        } else if (query == L"sell-return") {
-            callMethod(Device { KnownConnParams { serial } }, &Device::registerSellReturn, details, result);
-        } else if (query == L"report-z" || query == L"close-shift") {
-            callMethod(Device { KnownConnParams { serial } }, &Device::closeShift, details, result);
-        } else if (query == L"report-x") {
-            callMethod(Device { KnownConnParams { serial } }, &Device::reportX, details, result);
-        } else if (query == L"reset-state") {
-            callMethod(Device { KnownConnParams { serial } }, &Device::resetState, details, result);
-        } else {
-            throw Basic::Failure(KKM_FMT(Kkm::Mbs::c_requiresProperty, Mbs::c_query)); // NOLINT(*-exception-baseclass)
+            case Operation::BaseStatus:
+                callMethod(Device { KnownConnParams { serial } }, &Device::getStatus, result);
+                break;
+            case Operation::Status:
+                collectDataFromMethods(
+                    result,
+                    Device { KnownConnParams { serial } },
+                    &Device::getStatus,
+                    &Device::getShiftState,
+                    &Device::getReceiptState,
+                    &Device::getCashStat,
+                    &Device::getFndtOfdExchangeStatus,
+                    &Device::getFndtLastReceipt,
+                    &Device::getFndtLastDocument,
+                    &Device::getFndtErrors
+                );
+                break;
+            case Operation::FullStatus:
+                collectDataFromMethods(
+                    result,
+                    Device { KnownConnParams { serial } },
+                    &Device::getStatus,
+                    &Device::getShiftState,
+                    &Device::getReceiptState,
+                    &Device::getCashStat,
+                    &Device::getFndtOfdExchangeStatus,
+                    &Device::getFndtFnInfo,
+                    &Device::getFndtRegistrationInfo,
+                    &Device::getFndtLastRegistration,
+                    &Device::getFndtLastReceipt,
+                    &Device::getFndtLastDocument,
+                    &Device::getFndtErrors,
+                    &Device::getFfdVersion,
+                    &Device::getFwVersion
+                );
+                break;
+            case Operation::PrintDemo:
+                callMethod(Device { KnownConnParams { serial } }, &Device::printDemo, result);
+                break;
+            case Operation::PrintNonFiscalDocument:
+                callMethod(Device { KnownConnParams { serial } }, &Device::printNonFiscalDocument, details, result);
+                break;
+            case Operation::PrintInfo:
+                callMethod(Device { KnownConnParams { serial } }, &Device::printInfo, result);
+                break;
+            case Operation::PrintFnRegistrations:
+                callMethod(Device { KnownConnParams { serial } }, &Device::printFnRegistrations, result);
+                break;
+            case Operation::PrintOfdExchangeStatus:
+                callMethod(Device { KnownConnParams { serial } }, &Device::printOfdExchangeStatus, result);
+                break;
+            case Operation::PrintOfdTest:
+                callMethod(Device { KnownConnParams { serial } }, &Device::printOfdTest, result);
+                break;
+            case Operation::PrintCloseShiftReports:
+                callMethod(Device { KnownConnParams { serial } }, &Device::printCloseShiftReports, result);
+                break;
+            case Operation::PrintLastDocument:
+                callMethod(Device { KnownConnParams { serial } }, &Device::printLastDocument, result);
+                break;
+            case Operation::CashStat:
+                callMethod(Device { KnownConnParams { serial } }, &Device::getCashStat, result);
+                break;
+            case Operation::CashIn:
+                callMethod(Device { KnownConnParams { serial } }, &Device::registerCashIn, details, result);
+                break;
+            case Operation::CashOut:
+                callMethod(Device { KnownConnParams { serial } }, &Device::registerCashOut, details, result);
+                break;
+            case Operation::Sell:
+                callMethod(Device { KnownConnParams { serial } }, &Device::registerSell, details, result);
+                break;
+            case Operation::SellReturn:
+                callMethod(Device { KnownConnParams { serial } }, &Device::registerSellReturn, details, result);
+                break;
+            case Operation::CloseShift:
+                callMethod(Device { KnownConnParams { serial } }, &Device::closeShift, details, result);
+                break;
+            case Operation::ReportX:
+                callMethod(Device { KnownConnParams { serial } }, &Device::reportX, details, result);
+                break;
+            case Operation::ResetState:
+                callMethod(Device { KnownConnParams { serial } }, &Device::resetState, details, result);
+                break;
+            default:
+                throw Basic::Failure(KKM_FMT(Kkm::Mbs::c_requiresProperty, Mbs::c_query)); // NOLINT(*-exception-baseclass)
         }
 
 #if WITH_ASAN || WITH_CRTDBG
@@ -25,9 +25,7 @@ namespace Kkm {
     }
 
     Device::~Device() {
-        if (m_needToCancelReceipt && m_kkm.cancelReceipt() < 0) {
-            LOG_WARNING_TS(Wcs::c_cancelingError, m_logPrefix, m_serialNumber, m_kkm.errorDescription());
-        }
+        release();
         m_kkm.close();
     }
 
@@ -112,6 +110,33 @@ namespace Kkm {
         return m_serialNumber;
     }
 
+    void Device::logPrefix(const std::wstring_view logPrefix) {
+        m_logPrefix.assign(logPrefix);
+    }
+
+    bool Device::alive() {
+        if (!m_kkm.isOpened()) {
+            return false;
+        }
+        // Запрос серийного номера одновременно проверяет связь и то, что на порту всё та же ККМ.
+        m_kkm.setParam(Atol::LIBFPTR_PARAM_DATA_TYPE, Atol::LIBFPTR_DT_SERIAL_NUMBER);
+        if (m_kkm.queryData() < 0) {
+            m_kkm.resetError();
+            return false;
+        }
+        return m_kkm.getParamString(Atol::LIBFPTR_PARAM_SERIAL_NUMBER) == m_serialNumber;
+    }
+
+    void Device::release() {
+        if (m_needToCancelReceipt) {
+            if (m_kkm.cancelReceipt() < 0) {
+                LOG_WARNING_TS(Wcs::c_cancelingError, m_logPrefix, m_serialNumber, m_kkm.errorDescription());
+                m_kkm.resetError();
+            }
+            m_needToCancelReceipt = false;
+        }
+    }
+
     [[nodiscard, maybe_unused]]
     std::wstring Device::addMargins(const std::wstring_view text, int marginTop, int marginBottom) {
         Numeric::doubleClamp(marginTop, marginBottom, 0, 10);
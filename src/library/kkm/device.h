@@ -21,6 +21,9 @@ namespace Kkm {
         Device & operator=(Device &&) = delete;
 
         [[nodiscard]] const std::wstring & serialNumber() const;
+        void logPrefix(std::wstring_view);
+        [[nodiscard]] bool alive();
+        void release();
         void getStatus(StatusResult &);
         void getShiftState(ShiftStateResult &);
         void getReceiptState(ReceiptStateResult &);
@@ -0,0 +1,113 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#pragma once
+
+#include <lib/hash.h>
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <string_view>
+
+namespace Kkm {
+    // Операции с ККМ, доступные через HTTP-адаптер (kkmha) и загрузчик JSON (kkmjl).
+    enum class Operation : uint8_t {
+        BaseStatus,
+        Status,
+        FullStatus,
+        Learn,
+        ResetRegistry,
+        PrintDemo,
+        PrintNonFiscalDocument,
+        PrintInfo,
+        PrintFnRegistrations,
+        PrintOfdExchangeStatus,
+        PrintOfdTest,
+        PrintCloseShiftReports,
+        PrintLastDocument,
+        CashStat,
+        CashIn,
+        CashOut,
+        Sell,
+        SellReturn,
+        ReportX,
+        CloseShift,
+        ResetState,
+        Unknown
+    };
+
+    constexpr size_t c_operationCount { static_cast<size_t>(Operation::Unknown) };
+
+    // Запросы (Query) только читают состояние ККМ, команды (Command) его изменяют.
+    enum class OperationKind : uint8_t { Query, Command };
+
+    struct OperationName {
+        std::string_view m_name;
+        Operation m_operation;
+        OperationKind m_kind;
+    };
+
+    constexpr std::array c_operationNames {
+        OperationName { "base-status", Operation::BaseStatus, OperationKind::Query },
+        OperationName { "status", Operation::Status, OperationKind::Query },
+        OperationName { "full-status", Operation::FullStatus, OperationKind::Query },
+        OperationName { "learn", Operation::Learn, OperationKind::Command },
+        OperationName { "reset-registry", Operation::ResetRegistry, OperationKind::Command },
+        OperationName { "print-demo", Operation::PrintDemo, OperationKind::Command },
+        OperationName { "print-non-fiscal-doc", Operation::PrintNonFiscalDocument, OperationKind::Command },
+        OperationName { "print-info", Operation::PrintInfo, OperationKind::Command },
+        OperationName { "print-fn-registrations", Operation::PrintFnRegistrations, OperationKind::Command },
+        OperationName { "print-ofd-exchange-status", Operation::PrintOfdExchangeStatus, OperationKind::Command },
+        OperationName { "print-ofd-test", Operation::PrintOfdTest, OperationKind::Command },
+        OperationName { "print-close-shift-reports", Operation::PrintCloseShiftReports, OperationKind::Command },
+        OperationName { "print-last-document", Operation::PrintLastDocument, OperationKind::Command },
+        OperationName { "cash-stat", Operation::CashStat, OperationKind::Query },
+        OperationName { "cash-in", Operation::CashIn, OperationKind::Command },
+        OperationName { "cash-out", Operation::CashOut, OperationKind::Command },
+        OperationName { "sell", Operation::Sell, OperationKind::Command },
+        OperationName { "sell-return", Operation::SellReturn, OperationKind::Command },
+        OperationName { "report-x", Operation::ReportX, OperationKind::Command },
+        OperationName { "report-z", Operation::CloseShift, OperationKind::Command },
+        OperationName { "close-shift", Operation::CloseShift, OperationKind::Command },
+        OperationName { "reset-state", Operation::ResetState, OperationKind::Command }
+    };
+
+    constexpr Hash::Perfect<c_operationNames.size()> c_operationIndex {
+        [] {
+            std::array<std::string_view, c_operationNames.size()> keys {};
+            for (size_t i = 0; i < keys.size(); ++i) {
+                keys[i] = c_operationNames[i].m_name;
+            }
+            return keys;
+        } ()
+    };
+
+    // Поиск операции по имени без учёта регистра; для неизвестного имени возвращается nullptr.
+    [[nodiscard]]
+    constexpr const OperationName * findOperation(const std::string_view name) noexcept {
+        const auto index = c_operationIndex.find(name);
+        return index == c_operationIndex.c_npos ? nullptr : &c_operationNames[index];
+    }
+
+    [[nodiscard]]
+    constexpr Operation operation(const std::string_view name) noexcept {
+        const auto found = findOperation(name);
+        return found ? found->m_operation : Operation::Unknown;
+    }
+
+    // Каждая операция должна иметь хотя бы одно имя.
+    static_assert(
+        [] {
+            std::array<bool, c_operationCount> named {};
+            for (const auto & item : c_operationNames) {
+                named[static_cast<size_t>(item.m_operation)] = true;
+            }
+            for (const auto flag : named) {
+                if (!flag) {
+                    return false;
+                }
+            }
+            return true;
+        } ()
+    );
+}
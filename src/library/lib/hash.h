@@ -0,0 +1,109 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <bit>
+#include <array>
+#include <string_view>
+
+namespace Hash {
+    constexpr uint32_t c_fnvOffset { 2'166'136'261u };
+    constexpr uint32_t c_fnvPrime { 16'777'619u };
+
+    [[nodiscard, maybe_unused]]
+    constexpr char lowered(const char ch) noexcept {
+        return ch >= 'A' && ch <= 'Z' ? static_cast<char>(ch - 'A' + 'a') : ch;
+    }
+
+    // FNV-1a по символам в нижнем регистре (только ASCII).
+    [[nodiscard, maybe_unused]]
+    constexpr uint32_t fnv1aLowered(const std::string_view text, const uint32_t seed = c_fnvOffset) noexcept {
+        uint32_t hash { seed };
+        for (const auto ch : text) {
+            hash ^= static_cast<uint8_t>(lowered(ch));
+            hash *= c_fnvPrime;
+        }
+        return hash;
+    }
+
+    // Совершенная хеш-функция над небольшим набором ключей, известным на этапе компиляции. Ключи задаются
+    // в нижнем регистре, поиск регистр не учитывает. find() возвращает позицию ключа в исходном наборе
+    // или c_npos, если ключ не найден; на поиск тратится один проход хеша и одно сравнение строк.
+    template<size_t N, size_t S = std::bit_ceil(N * 2)>
+    requires (N > 0 && N < 255 && std::has_single_bit(S) && S >= N)
+    class Perfect {
+    public:
+        static constexpr size_t c_npos { N };
+
+    private:
+        static constexpr uint8_t c_empty { 0xff };
+        static constexpr uint32_t c_seedLimit { 100'000 };
+
+        std::array<std::string_view, N> m_keys;
+        std::array<uint8_t, S> m_slots {};
+        uint32_t m_seed { c_fnvOffset };
+
+        // Младшие биты FNV-1a зависят только от младших битов входа, поэтому перед выбором ячейки
+        // хеш перемешивается (финализатор lowbias32).
+        [[nodiscard]]
+        static constexpr size_t slot(uint32_t hash) noexcept {
+            hash ^= hash >> 16;
+            hash *= 0x7feb'352du;
+            hash ^= hash >> 15;
+            hash *= 0x846c'a68bu;
+            hash ^= hash >> 16;
+            return hash & (S - 1);
+        }
+
+        [[nodiscard]]
+        constexpr bool place(const uint32_t seed) noexcept {
+            m_slots.fill(c_empty);
+            for (size_t i = 0; i < N; ++i) {
+                auto & cell = m_slots[slot(fnv1aLowered(m_keys[i], seed))];
+                if (cell != c_empty) {
+                    return false;
+                }
+                cell = static_cast<uint8_t>(i);
+            }
+            return true;
+        }
+
+    public:
+        Perfect() = delete;
+
+        consteval explicit Perfect(const std::array<std::string_view, N> & keys) : m_keys(keys) {
+            for (uint32_t seed = c_fnvOffset; seed != c_fnvOffset + c_seedLimit; ++seed) {
+                if (place(seed)) {
+                    m_seed = seed;
+                    return;
+                }
+            }
+            // Недостижимо для разумных наборов; выход из consteval-конструктора через throw - ошибка компиляции.
+            throw "Hash::Perfect: no suitable seed";
+        }
+
+        [[nodiscard]]
+        constexpr size_t find(const std::string_view key) const noexcept {
+            const auto index = m_slots[slot(fnv1aLowered(key, m_seed))];
+            if (index == c_empty) {
+                return c_npos;
+            }
+            const auto candidate = m_keys[index];
+            if (candidate.size() != key.size()) {
+                return c_npos;
+            }
+            for (size_t i = 0; i < key.size(); ++i) {
+                if (lowered(key[i]) != candidate[i]) {
+                    return c_npos;
+                }
+            }
+            return index;
+        }
+
+        [[nodiscard]] constexpr std::string_view key(const size_t index) const noexcept { return m_keys[index]; }
+        [[nodiscard]] static constexpr size_t size() noexcept { return N; }
+    };
+}
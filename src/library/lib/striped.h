@@ -0,0 +1,182 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <bit>
+#include <array>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace Striped {
+    // Размер строки кэша процессора; std::hardware_destructive_interference_size не везде одинаков
+    // и вызывает предупреждения компиляторов, поэтому задаём явно.
+    constexpr size_t c_cacheLine { 64 };
+
+    struct None {};
+
+    // Ассоциативный массив, разбитый на S независимых полос (stripes), каждая под своей блокировкой.
+    // Полоса выбирается по хешу ключа, поэтому потоки, работающие с разными ключами, почти не мешают
+    // друг другу, а чтения одной полосы выполняются параллельно (std::shared_mutex).
+    // A - дополнительные данные полосы (например, очередь сроков хранения), защищённые той же блокировкой.
+    template<class K, class V, class H = std::hash<K>, size_t S = 16, class A = None>
+    requires (std::has_single_bit(S))
+    class Map {
+    public:
+        using Items = std::unordered_map<K, V, H>;
+        using Attachment = A;
+
+    private:
+        struct alignas(c_cacheLine) Stripe {
+            mutable std::shared_mutex m_mutex {};
+            Items m_items {};
+            A m_attachment {};
+        };
+
+        template<class F>
+        static decltype(auto) apply(F && f, Stripe & part) {
+            if constexpr (std::is_invocable_v<F, Items &, A &>) {
+                return std::invoke(std::forward<F>(f), part.m_items, part.m_attachment);
+            } else {
+                return std::invoke(std::forward<F>(f), part.m_items);
+            }
+        }
+
+        std::array<Stripe, S> m_stripes {};
+
+        // Хеш перемешивается (хеширование Фибоначчи), и полоса выбирается по старшим битам: младшие
+        // биты остаются для распределения по корзинам внутри полосы.
+        [[nodiscard]]
+        static constexpr size_t index(const size_t hash) noexcept {
+            if constexpr (S == 1) {
+                return 0;
+            } else {
+                constexpr auto shift = 64 - std::countr_zero(S);
+                return static_cast<size_t>((static_cast<uint64_t>(hash) * 0x9e37'79b9'7f4a'7c15ull) >> shift);
+            }
+        }
+
+        [[nodiscard]]
+        Stripe & stripe(const K & key) noexcept {
+            return m_stripes[index(H {}(key))];
+        }
+
+        [[nodiscard]]
+        const Stripe & stripe(const K & key) const noexcept {
+            return m_stripes[index(H {}(key))];
+        }
+
+    public:
+        Map() = default;
+        Map(const Map &) = delete;
+        Map(Map &&) = delete;
+        ~Map() = default;
+
+        Map & operator=(const Map &) = delete;
+        Map & operator=(Map &&) = delete;
+
+        [[nodiscard]]
+        std::optional<V> find(const K & key) const {
+            const auto & part = stripe(key);
+            std::shared_lock lock(part.m_mutex);
+            const auto it = part.m_items.find(key);
+            if (it == part.m_items.end()) {
+                return std::nullopt;
+            }
+            return it->second;
+        }
+
+        // Разделяемый доступ к значению: f(const V &) вызывается, только если ключ найден.
+        template<class F>
+        bool visit(const K & key, F && f) const {
+            const auto & part = stripe(key);
+            std::shared_lock lock(part.m_mutex);
+            const auto it = part.m_items.find(key);
+            if (it == part.m_items.end()) {
+                return false;
+            }
+            std::invoke(std::forward<F>(f), it->second);
+            return true;
+        }
+
+        template<class T>
+        void assign(const K & key, T && value) {
+            auto & part = stripe(key);
+            std::unique_lock lock(part.m_mutex);
+            part.m_items.insert_or_assign(key, std::forward<T>(value));
+        }
+
+        bool erase(const K & key) {
+            auto & part = stripe(key);
+            std::unique_lock lock(part.m_mutex);
+            return part.m_items.erase(key) > 0;
+        }
+
+        // Монопольный доступ к полосе, в которую попадает ключ: f(Items &) или f(Items &, A &).
+        template<class F>
+        decltype(auto) exclusive(const K & key, F && f) {
+            auto & part = stripe(key);
+            std::unique_lock lock(part.m_mutex);
+            return apply(std::forward<F>(f), part);
+        }
+
+        // Монопольный доступ к полосе по номеру (берётся по модулю S), например для стрелки, обходящей полосы.
+        template<class F>
+        decltype(auto) exclusiveAt(const size_t part, F && f) {
+            auto & target = m_stripes[part & (S - 1)];
+            std::unique_lock lock(target.m_mutex);
+            return apply(std::forward<F>(f), target);
+        }
+
+        // Поочерёдный монопольный доступ ко всем полосам; результаты f складываются.
+        template<class F>
+        size_t sweep(F && f) {
+            size_t total { 0 };
+            for (auto & part : m_stripes) {
+                std::unique_lock lock(part.m_mutex);
+                total += static_cast<size_t>(apply(f, part));
+            }
+            return total;
+        }
+
+        // Полосы обходятся по очереди, и одновременно блокируется только одна из них.
+        template<class P>
+        size_t eraseIf(P && predicate) {
+            size_t erased { 0 };
+            for (auto & part : m_stripes) {
+                std::unique_lock lock(part.m_mutex);
+                erased += std::erase_if(part.m_items, predicate);
+            }
+            return erased;
+        }
+
+        // Размер приблизительный: полосы могут меняться, пока обходятся остальные.
+        [[nodiscard]]
+        size_t size() const {
+            size_t total { 0 };
+            for (const auto & part : m_stripes) {
+                std::shared_lock lock(part.m_mutex);
+                total += part.m_items.size();
+            }
+            return total;
+        }
+
+        void clear() {
+            for (auto & part : m_stripes) {
+                std::unique_lock lock(part.m_mutex);
+                part.m_items.clear();
+                part.m_attachment = A {};
+            }
+        }
+
+        [[nodiscard]] static constexpr size_t stripes() noexcept { return S; }
+        [[nodiscard]] static size_t stripeOf(const K & key) noexcept { return index(H {}(key)); }
+    };
+}
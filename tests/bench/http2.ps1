@@ -0,0 +1,54 @@
+# Copyright (c) 2025 Vitaly Anasenko
+# Distributed under the MIT License, see accompanying file LICENSE.txt
+
+# Сравнение HTTP/1.1 и HTTP/2 на одном и том же маршруте с помощью h2load (из состава nghttp2).
+# Для HTTP/1.1 каждый клиент держит одно постоянное соединение без конвейеризации, для HTTP/2 -
+# одно соединение с несколькими параллельными потоками.
+
+param(
+    [string] $Url = "https://127.0.0.1:5757/ping",
+    [int] $Requests = 20000,
+    [int] $Clients = 10,
+    [int] $Streams = 10,
+    [string] $Secret = "",
+    [string] $H2Load = "h2load"
+)
+
+$ErrorActionPreference = "Stop"
+
+function Measure-Protocol([string] $Name, [string[]] $Options) {
+    $log = [System.IO.Path]::GetTempFileName()
+    $arguments = @("-n", $Requests, "-c", $Clients, "--log-file=$log") + $Options
+    if ($Secret) {
+        $arguments += @("-H", "x-secret: $Secret")
+    }
+    $output = & $H2Load @arguments $Url 2>&1 | Out-String
+    if ($LASTEXITCODE -ne 0) {
+        throw "h2load ($Name): $output"
+    }
+
+    $rps = if ($output -match "finished in [^,]+, ([\d.]+) req/s") { [double] $Matches[1] } else { 0.0 }
+    $succeeded = if ($output -match "(\d+) succeeded") { [int] $Matches[1] } else { 0 }
+
+    # Строка журнала: время начала, статус ответа, длительность запроса (мкс).
+    $durations = Get-Content $log | ForEach-Object { [double] ($_ -split "`t")[2] } | Sort-Object
+    Remove-Item $log
+    $p50 = $p99 = 0.0
+    if ($durations.Count -gt 0) {
+        $p50 = $durations[[math]::Ceiling($durations.Count * 0.50) - 1] / 1000
+        $p99 = $durations[[math]::Ceiling($durations.Count * 0.99) - 1] / 1000
+    }
+
+    [pscustomobject] @{
+        Protocol = $Name
+        Succeeded = $succeeded
+        "Req/s" = [math]::Round($rps, 1)
+        "p50, ms" = [math]::Round($p50, 2)
+        "p99, ms" = [math]::Round($p99, 2)
+    }
+}
+
+@(
+    Measure-Protocol "HTTP/1.1" @("--h1", "-m", "1")
+    Measure-Protocol "HTTP/2" @("-m", $Streams)
+) | Format-Table -AutoSize
@@ -0,0 +1,50 @@
+# Copyright (c) 2025 Vitaly Anasenko
+# Distributed under the MIT License, see accompanying file LICENSE.txt
+
+# Начальный корпус для fuzz_http_parser: HTTP-запросы к адаптеру, собранные из примеров examples/json.
+# cmake -DEXAMPLES_DIR=<examples/json> -DOUTPUT_DIR=<каталог корпуса> -P http_corpus.cmake
+
+cmake_minimum_required(VERSION 3.28)
+
+if (NOT EXAMPLES_DIR OR NOT OUTPUT_DIR)
+    message(FATAL_ERROR "EXAMPLES_DIR and OUTPUT_DIR are required")
+endif ()
+
+set(KKMHA_QUERIES base-status status full-status cash-stat)
+set(KKMHA_SERIAL 0123456789)
+set(KKMHA_HEAD_FIELDS "Host: 127.0.0.1:5757\r\nX-Secret: 1234567890abcdef\r\n")
+
+# Первый байт входа задаёт размер порции чтения (см. http_parser_fuzz.cpp): весь запрос за одно чтение
+# и порции по 8 байт.
+string(ASCII 127 KKMHA_WHOLE)
+string(ASCII 7 KKMHA_SPLIT)
+
+file(MAKE_DIRECTORY "${OUTPUT_DIR}")
+file(GLOB KKMHA_EXAMPLES "${EXAMPLES_DIR}/*.json")
+
+foreach (example IN LISTS KKMHA_EXAMPLES)
+    get_filename_component(operation "${example}" NAME_WE)
+    if (operation STREQUAL "learn")
+        set(target "/kkm/learn")
+    else ()
+        set(target "/kkm/${KKMHA_SERIAL}/${operation}")
+    endif ()
+
+    if (operation IN_LIST KKMHA_QUERIES)
+        set(request "GET ${target} HTTP/1.1\r\n${KKMHA_HEAD_FIELDS}Connection: keep-alive\r\n\r\n")
+    else ()
+        file(READ "${example}" body)
+        string(LENGTH "${body}" length)
+        set(
+            request
+            "POST ${target} HTTP/1.1\r\n${KKMHA_HEAD_FIELDS}"
+            "Content-Type: application/json; charset=utf-8\r\n"
+            "X-Idempotency-Key: ${operation}-0001\r\n"
+            "Content-Length: ${length}\r\n\r\n${body}"
+        )
+        string(JOIN "" request ${request})
+    endif ()
+
+    file(WRITE "${OUTPUT_DIR}/${operation}.http" "${KKMHA_WHOLE}${request}")
+    file(WRITE "${OUTPUT_DIR}/${operation}-split.http" "${KKMHA_SPLIT}${request}")
+endforeach ()
@@ -0,0 +1,78 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#include <string>
+#include <string_view>
+#include <catch2/catch_test_macros.hpp>
+#include <http_gzip.h>
+
+namespace UnitTests {
+    using namespace std::string_view_literals;
+
+    std::string inflated(const std::string_view data) {
+        z_stream stream {};
+        REQUIRE(inflateInit2(&stream, Http::Gzip::c_windowBits) == Z_OK);
+        std::string output(1'048'576, '\0');
+        stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data())); // NOLINT(*-const-cast)
+        stream.avail_in = static_cast<uInt>(data.size());
+        stream.next_out = reinterpret_cast<Bytef *>(output.data());
+        stream.avail_out = static_cast<uInt>(output.size());
+        const auto result = inflate(&stream, Z_FINISH);
+        output.resize(stream.total_out);
+        inflateEnd(&stream);
+        REQUIRE(result == Z_STREAM_END);
+        return output;
+    }
+
+    TEST_CASE("gzip", "[http]") {
+        SECTION("accepted") {
+            using Http::Gzip::accepted;
+            STATIC_REQUIRE(accepted("gzip"sv));
+            STATIC_REQUIRE(accepted("gzip, deflate, br"sv));
+            STATIC_REQUIRE(accepted("deflate, GZip;q=0.8"sv));
+            STATIC_REQUIRE(accepted("x-gzip"sv));
+            STATIC_REQUIRE(accepted("*"sv));
+            STATIC_REQUIRE(accepted("br;q=1.0, *;q=0.1"sv));
+            STATIC_REQUIRE_FALSE(accepted(""sv));
+            STATIC_REQUIRE_FALSE(accepted("identity"sv));
+            STATIC_REQUIRE_FALSE(accepted("deflate, br"sv));
+            STATIC_REQUIRE_FALSE(accepted("gzip;q=0"sv));
+            STATIC_REQUIRE_FALSE(accepted("gzip; q=0.000"sv));
+            STATIC_REQUIRE_FALSE(accepted("gzip;q=0, *"sv));
+            STATIC_REQUIRE_FALSE(accepted("*;q=0"sv));
+            STATIC_REQUIRE_FALSE(accepted("gzipped"sv));
+        }
+
+        SECTION("compressible") {
+            using Http::Gzip::compressible;
+            STATIC_REQUIRE(compressible("application/json"sv));
+            STATIC_REQUIRE(compressible("text/html; charset=utf-8"sv));
+            STATIC_REQUIRE(compressible("text/plain; version=0.0.4; charset=utf-8"sv));
+            STATIC_REQUIRE(compressible("application/javascript"sv));
+            STATIC_REQUIRE(compressible("image/svg+xml"sv));
+            STATIC_REQUIRE(compressible("application/ld+json"sv));
+            STATIC_REQUIRE_FALSE(compressible("image/png"sv));
+            STATIC_REQUIRE_FALSE(compressible("application/zip"sv));
+            STATIC_REQUIRE_FALSE(compressible("application/octet-stream"sv));
+            STATIC_REQUIRE_FALSE(compressible(""sv));
+        }
+
+        SECTION("compress") {
+            std::string text {};
+            for (int i = 0; i < 200; ++i) {
+                text.append(R"({"success":true,"message":"Ok","shiftState":"opened","documentNumber":)");
+                text.append(std::to_string(i)).append("},");
+            }
+            const auto packed = Http::Gzip::compress(text);
+            REQUIRE_FALSE(packed.empty());
+            REQUIRE(packed.size() < text.size());
+            REQUIRE(packed.substr(0, 2) == "\x1f\x8b"sv);
+            REQUIRE(inflated(packed) == text);
+        }
+
+        SECTION("incompressible") {
+            REQUIRE(Http::Gzip::compress(""sv).empty());
+            REQUIRE(Http::Gzip::compress("{}"sv).empty());
+        }
+    }
+}
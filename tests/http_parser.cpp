@@ -0,0 +1,174 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#include <cstring>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <http_parser.h>
+#include <http_request.h>
+#include <log/variables.h>
+
+namespace UnitTests {
+    using namespace std::string_literals;
+    using namespace std::string_view_literals;
+
+    constexpr std::string_view c_serialNumber { "0123456789" };
+    constexpr std::string_view c_headFields { "Host: 127.0.0.1:5757\r\nX-Secret: 1234567890abcdef\r\n" };
+
+    struct Example {
+        std::string m_request;
+        size_t m_bodySize;
+    };
+
+    // Запросы собираются так же, как начальный корпус в http_corpus.cmake.
+    std::vector<Example> loadExamples() {
+        static const std::vector<std::string_view> queries { "base-status", "status", "full-status", "cash-stat" };
+        std::vector<Example> examples {};
+        for (const auto & entry : std::filesystem::directory_iterator { KKMHA_EXAMPLES_DIR }) {
+            if (entry.path().extension() != ".json") {
+                continue;
+            }
+            const auto operation = entry.path().stem().string();
+            const auto target
+                = operation == "learn" ? "/kkm/learn"s : "/kkm/"s.append(c_serialNumber).append("/").append(operation);
+            std::string request {};
+            std::string body {};
+            if (std::ranges::find(queries, operation) != queries.end()) {
+                request.append("GET ").append(target).append(" HTTP/1.1\r\n").append(c_headFields);
+                request.append("Connection: keep-alive\r\n\r\n");
+            } else {
+                std::ifstream file { entry.path(), std::ios::binary };
+                body.assign(std::istreambuf_iterator<char> { file }, std::istreambuf_iterator<char> {});
+                request.append("POST ").append(target).append(" HTTP/1.1\r\n").append(c_headFields);
+                request.append("Content-Type: application/json; charset=utf-8\r\n");
+                request.append("X-Idempotency-Key: ").append(operation).append("-0001\r\n");
+                request.append("Content-Length: ").append(std::to_string(body.size())).append("\r\n\r\n");
+                request.append(body);
+            }
+            examples.emplace_back(std::move(request), body.size());
+        }
+        return examples;
+    }
+
+    // Разбор запроса, поступающего в буфер порциями по portion байт.
+    Http::Status parse(const std::string_view data, const size_t portion, size_t * bodySize = nullptr) {
+        Asio::StreamBuffer buffer {};
+        Http::Request request { Asio::IpAddress {} };
+        Http::Parser parser { request };
+        for (size_t offset = 0; offset < data.size() && request.m_response.m_status == Http::Status::Ok;) {
+            const auto chunk = std::min(portion, data.size() - offset);
+            const auto target = buffer.prepare(chunk);
+            std::memcpy(target.data(), data.data() + offset, chunk);
+            buffer.commit(chunk);
+            offset += chunk;
+            parser(buffer);
+        }
+        parser.complete();
+        if (bodySize) {
+            *bodySize = request.m_body.size();
+        }
+        return request.m_response.m_status;
+    }
+
+    std::string manyFields(const size_t count) {
+        std::string request { "GET /kkm/0123456789/status HTTP/1.1\r\n" };
+        for (size_t i = 0; i < count; ++i) {
+            request.append("X-Field-").append(std::to_string(i)).append(": value\r\n");
+        }
+        request.append("\r\n");
+        return request;
+    }
+
+    std::string longField(const size_t size) {
+        std::string request { "GET /kkm/0123456789/status HTTP/1.1\r\nX-Long: " };
+        request.append(size, 'x').append("\r\n\r\n");
+        return request;
+    }
+
+    std::string largeBody(const size_t size) {
+        std::string request { "POST /kkm/0123456789/sell HTTP/1.1\r\nContent-Length: " };
+        request.append(std::to_string(size)).append("\r\n\r\n").append(size, ' ');
+        return request;
+    }
+
+    TEST_CASE("parser", "[http]") {
+        Log::Console::s_level = Log::c_levelNone;
+
+        const auto examples = loadExamples();
+        REQUIRE_FALSE(examples.empty());
+        for (const auto & example : examples) {
+            for (const size_t portion : { example.m_request.size(), size_t { 16 }, size_t { 1 } }) {
+                size_t bodySize { 0 };
+                REQUIRE(parse(example.m_request, portion, &bodySize) == Http::Status::Ok);
+                REQUIRE(bodySize == example.m_bodySize);
+            }
+        }
+
+        REQUIRE(parse(manyFields(Http::Scanner::c_fieldsLimit), 64) == Http::Status::Ok);
+        REQUIRE(parse(manyFields(Http::Scanner::c_fieldsLimit + 1), 64) == Http::Status::BadRequest);
+        REQUIRE(parse(longField(8'192), 64) == Http::Status::Ok);
+        REQUIRE(parse(largeBody(Http::c_requestBodySizeLimit), 4'096) == Http::Status::Ok);
+        REQUIRE(parse(largeBody(Http::c_requestBodySizeLimit + 1), 4'096) == Http::Status::BadRequest);
+
+        {
+            constexpr auto data { "GET /kkm/0123456789/status?fresh=1&pretty&x=a=b HTTP/1.1\r\n\r\n"sv };
+            Asio::StreamBuffer buffer {};
+            Http::Request request { Asio::IpAddress {} };
+            Http::Parser parser { request };
+            std::memcpy(buffer.prepare(data.size()).data(), data.data(), data.size());
+            buffer.commit(data.size());
+            parser(buffer);
+            parser.complete();
+            REQUIRE(request.m_response.m_status == Http::Status::Ok);
+            REQUIRE(request.m_path == "/kkm/0123456789/status"sv);
+            REQUIRE(request.parameter("fresh") == "1"sv);
+            REQUIRE(request.parameter("pretty").empty());
+            REQUIRE(request.parameter("x") == "a=b"sv);
+            REQUIRE(request.parameter("fre").empty());
+        }
+    }
+
+    TEST_CASE("parser benchmark", "[http][!benchmark]") {
+        Log::Console::s_level = Log::c_levelNone;
+
+        const auto examples = loadExamples();
+        const auto fields = manyFields(Http::Scanner::c_fieldsLimit);
+        const auto field = longField(8'192);
+        const auto body = largeBody(65'536);
+
+        BENCHMARK("examples, single read") {
+            size_t ok { 0 };
+            for (const auto & example : examples) {
+                ok += parse(example.m_request, example.m_request.size()) == Http::Status::Ok;
+            }
+            return ok;
+        };
+
+        BENCHMARK("examples, 16-byte reads") {
+            size_t ok { 0 };
+            for (const auto & example : examples) {
+                ok += parse(example.m_request, 16) == Http::Status::Ok;
+            }
+            return ok;
+        };
+
+        BENCHMARK("64 fields, 64-byte reads") {
+            return parse(fields, 64);
+        };
+
+        BENCHMARK("8 KiB field, 64-byte reads") {
+            return parse(field, 64);
+        };
+
+        BENCHMARK("64 KiB body, 1 KiB reads") {
+            return parse(body, 1'024);
+        };
+    }
+}
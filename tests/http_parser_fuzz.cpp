@@ -0,0 +1,71 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <string_view>
+#include <http_parser.h>
+#include <http_request.h>
+#include <log/variables.h>
+
+namespace FuzzTests {
+    // Первый байт входа задаёт размер порции: запрос поступает в буфер частями, как при нескольких
+    // чтениях из сокета, и разбор выполняется после каждой порции.
+    void parse(const uint8_t * data, size_t size) {
+        if (size == 0) {
+            return;
+        }
+        const size_t portion { 1 + static_cast<size_t>(data[0]) };
+        ++data;
+        --size;
+
+        Asio::StreamBuffer buffer {};
+        Http::Request request { Asio::IpAddress {} };
+        Http::Parser parser { request };
+
+        for (size_t offset = 0; offset < size && request.m_response.m_status == Http::Status::Ok;) {
+            const auto chunk = std::min(portion, size - offset);
+            const auto target = buffer.prepare(chunk);
+            std::memcpy(target.data(), data + offset, chunk);
+            buffer.commit(chunk);
+            offset += chunk;
+            parser(buffer);
+        }
+        parser.complete();
+
+        // Все представления запроса обязаны указывать внутрь буфера приёма.
+        const auto received = buffer.data();
+        const auto begin = static_cast<const char *>(received.data());
+        const auto end = begin + received.size();
+        const auto inside = [begin, end] (const std::string_view view) {
+            return view.empty() || (view.data() >= begin && view.data() + view.size() <= end);
+        };
+
+        if (!inside(request.m_verb) || !inside(request.m_path) || !inside(request.m_body)) {
+            std::abort();
+        }
+        for (const auto & [name, value] : request.m_header) {
+            if (name.empty() || !inside(name) || !inside(value)) {
+                std::abort();
+            }
+        }
+        if (request.m_response.m_status == Http::Status::Ok) {
+            if (request.m_path.empty() || request.m_hint.empty() || request.m_method == Http::Method::NotImplemented) {
+                std::abort();
+            }
+        }
+    }
+}
+
+extern "C" int LLVMFuzzerInitialize(int *, char ***) {
+    Log::Console::s_level = Log::c_levelNone;
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t * data, const size_t size) {
+    FuzzTests::parse(data, size);
+    return 0;
+}
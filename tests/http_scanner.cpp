@@ -0,0 +1,296 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#include <cctype>
+#include <algorithm>
+#include <istream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <http_scanner.h>
+
+namespace UnitTests {
+    using namespace std::string_literals;
+    using namespace std::string_view_literals;
+
+    using Http::Scanner;
+
+    constexpr size_t c_bodyLimit { 131'072 };
+
+    constexpr std::string_view c_getRequest {
+        "GET /kkm/0123456789/status HTTP/1.1\r\n"
+        "Host: 127.0.0.1:5757\r\n"
+        "User-Agent: curl/8.9.1\r\n"
+        "Accept: application/json\r\n"
+        "X-Secret: 1234567890abcdef\r\n"
+        "Connection: keep-alive\r\n"
+        "\r\n"
+    };
+
+    constexpr std::string_view c_postRequest {
+        "POST /kkm/0123456789/cash-in HTTP/1.1\r\n"
+        "Host: 127.0.0.1:5757\r\n"
+        "Content-Type: application/json; charset=utf-8\r\n"
+        "X-Secret: 1234567890abcdef\r\n"
+        "X-Idempotency-Key: 6f1c8a4e-1d2b-4c3a-9e7f-0a1b2c3d4e5f\r\n"
+        "Content-Length: 41\r\n"
+        "\r\n"
+        "{\"cashier\":{\"name\":\"Test\"},\"sum\":1000.00}\n"
+    };
+
+    // Прежний разбор через std::istream: построчное копирование полей в std::unordered_map и чтение тела порциями.
+    struct LegacyRequest {
+        std::unordered_map<std::string, std::string> m_header {};
+        std::string m_verb {};
+        std::string m_path {};
+        std::string m_body {};
+    };
+
+    void trim(std::string & text) {
+        const auto first = text.find_first_not_of(" \t\r\n");
+        if (first == std::string::npos) {
+            text.clear();
+            return;
+        }
+        text.erase(text.find_last_not_of(" \t\r\n") + 1);
+        text.erase(0, first);
+    }
+
+    LegacyRequest legacyParse(const std::string_view data) {
+        LegacyRequest request {};
+        std::istringstream input { std::string { data } };
+        std::noskipws(input);
+
+        std::string line;
+        std::getline(input, line);
+        const auto pos1 = line.find(' ');
+        const auto pos2 = line.find_first_of(" ?#\r\n", pos1 + 1);
+        request.m_verb.assign(line, 0, pos1);
+        request.m_path.assign(line, pos1 + 1, pos2 - pos1 - 1);
+
+        size_t expected { 0 };
+        while (std::getline(input, line)) {
+            trim(line);
+            if (line.empty()) {
+                break;
+            }
+            const auto separator = line.find(':');
+            std::string field { line.substr(0, separator) }, value { line.substr(separator + 1) };
+            trim(field);
+            trim(value);
+            std::ranges::transform(field, field.begin(), [] (const unsigned char ch) { return std::tolower(ch); });
+            if (field == "content-length") {
+                expected = std::stoull(value);
+            }
+            request.m_header[field] = value;
+        }
+
+        request.m_body.reserve(expected + 1);
+        char buffer[2'048];
+        while (input.read(buffer, sizeof(buffer))) {
+            request.m_body.append(buffer, sizeof(buffer));
+        }
+        request.m_body.append(buffer, input.gcount());
+        return request;
+    }
+
+    TEST_CASE("scanner", "[http]") {
+        SECTION("get") {
+            Scanner scanner { c_bodyLimit };
+            REQUIRE(scanner.feed(c_getRequest) == Scanner::Result::Complete);
+            REQUIRE(scanner.method() == Http::Method::Get);
+            REQUIRE(scanner.verb().view(c_getRequest) == "GET"sv);
+            REQUIRE(scanner.target().view(c_getRequest) == "/kkm/0123456789/status"sv);
+            REQUIRE(scanner.version().view(c_getRequest) == "HTTP/1.1"sv);
+            REQUIRE(scanner.fieldCount() == 5);
+            REQUIRE(scanner.field(3).m_name.view(c_getRequest) == "X-Secret"sv);
+            REQUIRE(scanner.field(3).m_value.view(c_getRequest) == "1234567890abcdef"sv);
+            REQUIRE(scanner.field(3).m_field == Http::Field::XSecret);
+            REQUIRE(scanner.field(4).m_field == Http::Field::Connection);
+            REQUIRE(scanner.field(0).m_field == Http::Field::Other);
+            REQUIRE(scanner.body().view(c_getRequest).empty());
+        }
+
+        SECTION("post") {
+            Scanner scanner { c_bodyLimit };
+            // Байты за пределами Content-Length к телу не относятся.
+            REQUIRE(scanner.feed(c_postRequest) == Scanner::Result::Complete);
+            REQUIRE(scanner.method() == Http::Method::Post);
+            REQUIRE(scanner.body().view(c_postRequest) == "{\"cashier\":{\"name\":\"Test\"},\"sum\":1000.00}"sv);
+            REQUIRE(scanner.expecting(c_postRequest.size()) == 0);
+        }
+
+        SECTION("incremental") {
+            // Данные поступают по одному байту, буфер каждый раз пересоздаётся.
+            Scanner scanner { c_bodyLimit };
+            const auto complete = c_postRequest.size() - 1;
+            for (size_t size = 1; size < complete; ++size) {
+                const std::string chunk { c_postRequest.substr(0, size) };
+                REQUIRE(scanner.feed(chunk) == Scanner::Result::Partial);
+            }
+            const std::string full { c_postRequest.substr(0, complete) };
+            REQUIRE(scanner.feed(full) == Scanner::Result::Complete);
+            REQUIRE(scanner.target().view(full) == "/kkm/0123456789/cash-in"sv);
+            REQUIRE(scanner.body().view(full).size() == 41);
+        }
+
+        SECTION("expecting") {
+            Scanner scanner { c_bodyLimit };
+            const auto head = c_postRequest.substr(0, c_postRequest.find("\r\n\r\n") + 4);
+            REQUIRE(scanner.feed(head) == Scanner::Result::Partial);
+            REQUIRE(scanner.expecting(head.size()) == 41);
+        }
+
+        SECTION("pipelined") {
+            // Несколько запросов в одном буфере: каждый разбирается со своего смещения.
+            const std::string pipeline { std::string { c_getRequest } + std::string { c_postRequest } };
+            std::string_view rest { pipeline };
+            {
+                Scanner scanner { c_bodyLimit };
+                REQUIRE(scanner.feed(rest) == Scanner::Result::Complete);
+                REQUIRE(scanner.method() == Http::Method::Get);
+                REQUIRE(scanner.consumed() == c_getRequest.size());
+                rest.remove_prefix(scanner.consumed());
+            }
+            {
+                Scanner scanner { c_bodyLimit };
+                REQUIRE(scanner.feed(rest) == Scanner::Result::Complete);
+                REQUIRE(scanner.method() == Http::Method::Post);
+                REQUIRE(scanner.body().view(rest).size() == 41);
+                REQUIRE(scanner.consumed() == c_postRequest.size() - 1);
+            }
+        }
+
+        SECTION("query") {
+            constexpr auto request { "GET /static/index.html?v=1 HTTP/1.0\r\n\r\n"sv };
+            Scanner scanner { c_bodyLimit };
+            REQUIRE(scanner.feed(request) == Scanner::Result::Complete);
+            REQUIRE(scanner.target().view(request) == "/static/index.html"sv);
+            REQUIRE(scanner.query().view(request) == "v=1"sv);
+            REQUIRE(scanner.version().view(request) == "HTTP/1.0"sv);
+
+            constexpr auto fragment { "GET /kkm/0123456789/status?fresh=1&x#top HTTP/1.1\r\n\r\n"sv };
+            Scanner other { c_bodyLimit };
+            REQUIRE(other.feed(fragment) == Scanner::Result::Complete);
+            REQUIRE(other.target().view(fragment) == "/kkm/0123456789/status"sv);
+            REQUIRE(other.query().view(fragment) == "fresh=1&x"sv);
+            REQUIRE(other.version().view(fragment) == "HTTP/1.1"sv);
+        }
+
+        SECTION("errors") {
+            {
+                Scanner scanner { c_bodyLimit };
+                REQUIRE(scanner.feed("PUT /kkm HTTP/1.1\r\n\r\n"sv) == Scanner::Result::NotImplemented);
+            }
+            {
+                Scanner scanner { c_bodyLimit };
+                REQUIRE(scanner.feed("GET\r\n\r\n"sv) == Scanner::Result::BadRequest);
+            }
+            {
+                Scanner scanner { c_bodyLimit };
+                REQUIRE(scanner.feed("GET / HTTP/1.1\r\nbroken\r\n\r\n"sv) == Scanner::Result::BadRequest);
+            }
+            {
+                Scanner scanner { c_bodyLimit };
+                REQUIRE(scanner.feed("POST / HTTP/1.1\r\nContent-Length: 1x\r\n\r\n"sv) == Scanner::Result::BadRequest);
+            }
+            {
+                Scanner scanner { 16 };
+                constexpr auto request { "POST / HTTP/1.1\r\nContent-Length: 17\r\n\r\n"sv };
+                REQUIRE(scanner.feed(request) == Scanner::Result::BodyTooLarge);
+            }
+            {
+                std::string request { "GET / HTTP/1.1\r\n" };
+                for (size_t i = 0; i <= Scanner::c_fieldsLimit; ++i) {
+                    request.append("X-Field: value\r\n");
+                }
+                request.append("\r\n");
+                Scanner scanner { c_bodyLimit };
+                REQUIRE(scanner.feed(request) == Scanner::Result::BadRequest);
+            }
+            {
+                Scanner scanner { c_bodyLimit };
+                constexpr auto request { "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n1\r\nx\r\n0\r\n\r\n"sv };
+                REQUIRE(scanner.feed(request) == Scanner::Result::NotImplemented);
+            }
+            {
+                Scanner scanner { c_bodyLimit };
+                constexpr auto request { "POST / HTTP/1.1\r\nContent-Length: 2\r\nContent-Length: 30\r\n\r\n"sv };
+                REQUIRE(scanner.feed(request) == Scanner::Result::BadRequest);
+            }
+            {
+                Scanner scanner { c_bodyLimit };
+                constexpr auto request { "POST / HTTP/1.1\r\nContent-Length: 2\r\ncontent-length: 2\r\n\r\nab"sv };
+                REQUIRE(scanner.feed(request) == Scanner::Result::BadRequest);
+            }
+        }
+
+        SECTION("smuggling") {
+            // Тело GET-запроса не должно попасть в буфер как следующий конвейерный запрос.
+            constexpr auto smuggled { "POST /kkm/1/sell HTTP/1.1\r\n\r\n"sv };
+            std::string pipeline { "GET /kkm/1/status HTTP/1.1\r\nContent-Length: " };
+            pipeline.append(std::to_string(smuggled.size())).append("\r\n\r\n").append(smuggled);
+            pipeline.append(c_getRequest);
+            Scanner scanner { c_bodyLimit };
+            REQUIRE(scanner.feed(pipeline) == Scanner::Result::Complete);
+            REQUIRE(scanner.method() == Http::Method::Get);
+            REQUIRE(scanner.body().view(pipeline) == smuggled);
+            const std::string_view rest { std::string_view { pipeline }.substr(scanner.consumed()) };
+            REQUIRE(rest == c_getRequest);
+            Scanner next { c_bodyLimit };
+            REQUIRE(next.feed(rest) == Scanner::Result::Complete);
+            REQUIRE(next.method() == Http::Method::Get);
+        }
+
+        SECTION("header") {
+            Scanner scanner { c_bodyLimit };
+            REQUIRE(scanner.feed(c_getRequest) == Scanner::Result::Complete);
+            Http::Header header {};
+            for (size_t i = 0; i < scanner.fieldCount(); ++i) {
+                const auto & field = scanner.field(i);
+                header.emplace(field.m_field, field.m_name.view(c_getRequest), field.m_value.view(c_getRequest));
+            }
+            REQUIRE(header.has(Http::Field::XSecret));
+            REQUIRE(header[Http::Field::XSecret] == "1234567890abcdef"sv);
+            REQUIRE_FALSE(header.has(Http::Field::ContentType));
+            REQUIRE(header[Http::Field::ContentType].empty());
+            REQUIRE(header.find("user-agent"sv) != header.end());
+            REQUIRE(header.find("user-agent"sv)->second == "curl/8.9.1"sv);
+            REQUIRE(header.find("x-secret"sv) == header.end());
+        }
+
+        SECTION("legacy") {
+            const auto legacy = legacyParse(c_postRequest);
+            Scanner scanner { c_bodyLimit };
+            REQUIRE(scanner.feed(c_postRequest) == Scanner::Result::Complete);
+            REQUIRE(legacy.m_verb == scanner.verb().view(c_postRequest));
+            REQUIRE(legacy.m_path == scanner.target().view(c_postRequest));
+            REQUIRE(legacy.m_header.size() == scanner.fieldCount());
+            // Прежний разбор забирал в тело всё, что оставалось в буфере, включая завершающий перевод строки.
+            REQUIRE(legacy.m_body.starts_with(scanner.body().view(c_postRequest)));
+        }
+    }
+
+    TEST_CASE("scanner benchmark", "[http][!benchmark]") {
+        BENCHMARK("legacy get") {
+            return legacyParse(c_getRequest);
+        };
+
+        BENCHMARK("scanner get") {
+            Scanner scanner { c_bodyLimit };
+            return scanner.feed(c_getRequest);
+        };
+
+        BENCHMARK("legacy post") {
+            return legacyParse(c_postRequest);
+        };
+
+        BENCHMARK("scanner post") {
+            Scanner scanner { c_bodyLimit };
+            return scanner.feed(c_postRequest);
+        };
+    }
+}
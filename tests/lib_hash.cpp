@@ -0,0 +1,47 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#include <array>
+#include <string>
+#include <catch2/catch_test_macros.hpp>
+#include <lib/hash.h>
+
+namespace UnitTests {
+    using namespace std::string_literals;
+    using namespace std::string_view_literals;
+
+    constexpr Hash::Perfect<6> c_fields {
+        std::array {
+            "connection"sv, "content-length"sv, "content-type"sv, "host"sv, "x-idempotency-key"sv, "x-secret"sv
+        }
+    };
+
+    static_assert(c_fields.find("content-length"sv) == 1);
+    static_assert(c_fields.find("X-Secret"sv) == 5);
+    static_assert(c_fields.find("x-secrets"sv) == c_fields.c_npos);
+
+    TEST_CASE("hash", "[fnv1a]") {
+        REQUIRE(Hash::fnv1aLowered(""sv) == Hash::c_fnvOffset);
+        REQUIRE(Hash::fnv1aLowered("a"sv) == 0xe40c292cu);
+        REQUIRE(Hash::fnv1aLowered("foobar"sv) == 0xbf9cf968u);
+        REQUIRE(Hash::fnv1aLowered("FooBar"sv) == Hash::fnv1aLowered("foobar"sv));
+        REQUIRE(Hash::fnv1aLowered("foobar"sv, 1) != Hash::fnv1aLowered("foobar"sv));
+    }
+
+    TEST_CASE("hash", "[perfect]") {
+        REQUIRE(c_fields.size() == 6);
+        for (size_t i = 0; i < c_fields.size(); ++i) {
+            REQUIRE(c_fields.find(c_fields.key(i)) == i);
+        }
+        REQUIRE(c_fields.find("CONNECTION"sv) == 0);
+        REQUIRE(c_fields.find("Content-Type"s) == 2);
+        REQUIRE(c_fields.find(""sv) == c_fields.c_npos);
+        REQUIRE(c_fields.find("accept"sv) == c_fields.c_npos);
+        REQUIRE(c_fields.find("hosт"sv) == c_fields.c_npos);
+        REQUIRE(c_fields.find("x-secret "sv) == c_fields.c_npos);
+
+        constexpr Hash::Perfect<1> single { std::array { "only"sv } };
+        REQUIRE(single.find("ONLY"sv) == 0);
+        REQUIRE(single.find("none"sv) == single.c_npos);
+    }
+}
@@ -0,0 +1,234 @@
+// Copyright (c) 2025 Vitaly Anasenko
+// Distributed under the MIT License, see accompanying file LICENSE.txt
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <lib/striped.h>
+
+namespace UnitTests {
+    constexpr size_t c_keys { 256 };
+    constexpr size_t c_operations { 20'000 }; // На поток
+    constexpr size_t c_writeEvery { 16 }; // Доля записей при нагрузке, близкой к кэшу ответов
+
+    struct Value {
+        std::shared_ptr<std::string> m_data;
+        size_t m_version;
+    };
+
+    // Прежняя схема: один ассоциативный массив под единой блокировкой.
+    class Locked {
+        std::unordered_map<std::string, Value> m_items {};
+        std::mutex m_mutex {};
+
+    public:
+        std::optional<Value> find(const std::string & key) {
+            std::scoped_lock lock(m_mutex);
+            const auto it = m_items.find(key);
+            if (it == m_items.end()) {
+                return std::nullopt;
+            }
+            return it->second;
+        }
+
+        void assign(const std::string & key, Value value) {
+            std::scoped_lock lock(m_mutex);
+            m_items.insert_or_assign(key, std::move(value));
+        }
+    };
+
+    std::vector<std::string> keys() {
+        std::vector<std::string> result {};
+        result.reserve(c_keys);
+        for (size_t i = 0; i < c_keys; ++i) {
+            result.push_back("kkm::0123456789::status::" + std::to_string(i));
+        }
+        return result;
+    }
+
+    template<class M>
+    void fill(M & map, const std::vector<std::string> & keys) {
+        const auto data = std::make_shared<std::string>(512, 'x');
+        for (const auto & key : keys) {
+            map.assign(key, Value { data, 0 });
+        }
+    }
+
+    template<class M>
+    size_t hammer(M & map, const std::vector<std::string> & keys, const size_t threads) {
+        std::vector<std::thread> workers {};
+        std::vector<size_t> hits(threads, 0);
+        workers.reserve(threads);
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back(
+                [&map, &keys, &hits, t] () {
+                    const auto data = std::make_shared<std::string>(512, 'x');
+                    for (size_t i = 0; i < c_operations; ++i) {
+                        const auto & key = keys[(i * 7 + t * 31) % keys.size()];
+                        if (i % c_writeEvery == 0) {
+                            map.assign(key, Value { data, i });
+                        } else if (map.find(key)) {
+                            ++hits[t];
+                        }
+                    }
+                }
+            );
+        }
+        for (auto & worker : workers) {
+            worker.join();
+        }
+        size_t total { 0 };
+        for (const auto count : hits) {
+            total += count;
+        }
+        return total;
+    }
+
+    TEST_CASE("striped", "[striped]") {
+        SECTION("basics") {
+            Striped::Map<std::string, int> map {};
+            REQUIRE(map.size() == 0);
+            REQUIRE_FALSE(map.find("one").has_value());
+            map.assign("one", 1);
+            map.assign("two", 2);
+            map.assign("one", 11);
+            REQUIRE(map.size() == 2);
+            REQUIRE(map.find("one") == 11);
+            REQUIRE(map.find("two") == 2);
+            REQUIRE(map.erase("two"));
+            REQUIRE_FALSE(map.erase("two"));
+            REQUIRE(map.size() == 1);
+            map.exclusive("one", [] (auto & items) { ++items.at("one"); });
+            REQUIRE(map.find("one") == 12);
+            int seen { 0 };
+            REQUIRE(map.visit("one", [&seen] (const int value) { seen = value; }));
+            REQUIRE_FALSE(map.visit("two", [&seen] (const int) { seen = -1; }));
+            REQUIRE(seen == 12);
+            map.clear();
+            REQUIRE(map.size() == 0);
+        }
+
+        SECTION("erase if") {
+            Striped::Map<int, int> map {};
+            for (int i = 0; i < 1'000; ++i) {
+                map.assign(i, i);
+            }
+            REQUIRE(map.eraseIf([] (const auto & item) { return item.second % 2 == 0; }) == 500);
+            REQUIRE(map.size() == 500);
+            REQUIRE_FALSE(map.find(10).has_value());
+            REQUIRE(map.find(11) == 11);
+        }
+
+        SECTION("attachment") {
+            // Каждая полоса ведёт собственный журнал вставок под той же блокировкой.
+            Striped::Map<int, int, std::hash<int>, 4, std::vector<int>> map {};
+            for (int i = 0; i < 100; ++i) {
+                map.exclusive(
+                    i,
+                    [i] (auto & items, auto & journal) {
+                        items.emplace(i, i);
+                        journal.push_back(i);
+                    }
+                );
+            }
+            REQUIRE(map.sweep([] (const auto &, const auto & journal) { return journal.size(); }) == 100);
+            const auto erased = map.sweep(
+                [] (auto & items, auto & journal) {
+                    size_t count { 0 };
+                    for (const auto key : journal) {
+                        count += items.erase(key);
+                    }
+                    journal.clear();
+                    return count;
+                }
+            );
+            REQUIRE(erased == 100);
+            REQUIRE(map.size() == 0);
+        }
+
+        SECTION("stripe by index") {
+            using Map = Striped::Map<int, int, std::hash<int>, 4, std::vector<int>>;
+            Map map {};
+            for (int i = 0; i < 100; ++i) {
+                map.exclusive(
+                    i,
+                    [i] (auto & items, auto & journal) {
+                        items.emplace(i, i);
+                        journal.push_back(i);
+                    }
+                );
+            }
+            size_t total { 0 };
+            for (size_t part = 0; part < Map::stripes(); ++part) {
+                total += map.exclusiveAt(
+                    part,
+                    [part] (const auto & items, const auto & journal) {
+                        for (const auto key : journal) {
+                            REQUIRE(Map::stripeOf(key) == part);
+                        }
+                        return items.size();
+                    }
+                );
+            }
+            REQUIRE(total == 100);
+            // Номер полосы берётся по модулю их числа: стрелке достаточно наращивать счётчик.
+            REQUIRE(
+                map.exclusiveAt(4, [] (const auto & items) { return items.size(); })
+                == map.exclusiveAt(0, [] (const auto & items) { return items.size(); })
+            );
+        }
+
+        SECTION("distribution") {
+            // Ключи кэша отличаются короткими суффиксами; они должны расходиться по всем полосам.
+            using Map = Striped::Map<std::string, int>;
+            std::vector<size_t> counts(Map::stripes(), 0);
+            for (const auto & key : keys()) {
+                ++counts[Map::stripeOf(key)];
+            }
+            for (const auto count : counts) {
+                REQUIRE(count > 0);
+                REQUIRE(count < c_keys / Map::stripes() * 3);
+            }
+        }
+
+        SECTION("concurrent") {
+            const auto names = keys();
+            Striped::Map<std::string, Value> map {};
+            fill(map, names);
+            REQUIRE(hammer(map, names, 8) == 8 * (c_operations - c_operations / c_writeEvery));
+            REQUIRE(map.size() == c_keys);
+            for (const auto & name : names) {
+                const auto value = map.find(name);
+                REQUIRE(value.has_value());
+                REQUIRE(value->m_data->size() == 512);
+            }
+        }
+    }
+
+    TEST_CASE("striped benchmark", "[striped][!benchmark]") {
+        const auto names = keys();
+
+        for (const size_t threads : { 8, 16 }) {
+            const auto suffix = " x" + std::to_string(threads);
+
+            BENCHMARK_ADVANCED("single lock" + suffix)(Catch::Benchmark::Chronometer meter) {
+                Locked map {};
+                fill(map, names);
+                meter.measure([&] { return hammer(map, names, threads); });
+            };
+
+            BENCHMARK_ADVANCED("striped" + suffix)(Catch::Benchmark::Chronometer meter) {
+                Striped::Map<std::string, Value> map {};
+                fill(map, names);
+                meter.measure([&] { return hammer(map, names, threads); });
+            };
+        }
+    }
+}